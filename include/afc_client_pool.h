@@ -0,0 +1,76 @@
+#ifndef AFC_CLIENT_POOL_H
+#define AFC_CLIENT_POOL_H
+
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <libimobiledevice/libimobiledevice.h>
+#include <libimobiledevice/lockdown.h>
+#include <libimobiledevice/afc.h>
+
+class afc_client_pool {
+private:
+    struct pooled_client {
+        afc_client_t client;
+        lockdownd_service_descriptor_t service;
+        bool in_use;
+        bool healthy;
+        std::chrono::steady_clock::time_point last_used;
+    };
+
+    idevice_t device;
+    lockdownd_client_t lockdown_client;
+    std::vector<pooled_client> clients;
+    std::mutex lock;
+    std::mutex service_lock;  // lockdownd clients are not thread safe
+    std::condition_variable available;
+    bool pool_open;
+
+    // Helper methods
+    bool start_client(pooled_client& entry);
+    void stop_client(pooled_client& entry);
+    bool check_client(pooled_client& entry);
+    void give_back(size_t index, bool failed);
+
+public:
+    // RAII handle for a client borrowed from the pool
+    class lease {
+    private:
+        afc_client_pool* pool;
+        size_t index;
+        afc_client_t client;
+        bool failed;
+
+    public:
+        lease();
+        lease(afc_client_pool* owner, size_t slot, afc_client_t borrowed);
+        lease(lease&& other);
+        lease& operator=(lease&& other);
+        lease(const lease&) = delete;
+        lease& operator=(const lease&) = delete;
+        ~lease();
+
+        afc_client_t get() const;
+        explicit operator bool() const;
+        void mark_failed();
+        void release();
+    };
+
+    afc_client_pool(idevice_t dev, lockdownd_client_t lockdown, size_t size);
+    ~afc_client_pool();
+
+    // Connection methods
+    bool open();
+    void close();
+
+    // Borrowing clients
+    lease acquire();
+    lease try_acquire();
+
+    // Utility methods
+    size_t size() const;
+    size_t healthy_count();
+};
+
+#endif // AFC_CLIENT_POOL_H
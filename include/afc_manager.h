@@ -3,18 +3,120 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <functional>
+#include <mutex>
 #include <libimobiledevice/libimobiledevice.h>
 #include <libimobiledevice/lockdown.h>
 #include <libimobiledevice/afc.h>
+#include "chunk_sizer.h"
+#include "afc_client_pool.h"
+#include "afc_read_sink.h"
+
+// File type reported by AFC in st_ifmt
+enum class afc_file_type : uint8_t {
+    unknown,
+    regular,
+    directory,
+    symlink,
+    character_device,
+    block_device,
+    fifo,
+    socket
+};
 
 struct file_info {
     std::string filename;
     std::string full_path;
-    uint64_t file_size;
-    std::string modified_time;
-    bool is_directory;
+    std::string link_target;        // Only set for symlinks
+    uint64_t file_size = 0;
+    uint64_t modified_time = 0;     // st_mtime, nanoseconds since the epoch
+    uint64_t birth_time = 0;        // st_birthtime, nanoseconds since the epoch
+    uint64_t blocks = 0;            // st_blocks, 512-byte units
+    uint32_t link_count = 0;        // st_nlink
+    afc_file_type file_type = afc_file_type::unknown;
+
+    bool is_directory() const { return file_type == afc_file_type::directory; }
+};
+
+struct transfer_stats {
+    uint64_t bytes_transferred = 0;
+    double elapsed_seconds = 0.0;
+    double throughput_mbps = 0.0;   // MB/s over the whole transfer
+    unsigned connections_used = 0;
+    double read_seconds = 0.0;          // Time spent in AFC reads
+    double write_seconds = 0.0;         // Time spent writing to the destination
+    double read_stall_seconds = 0.0;    // Reader waiting for a free buffer (writer is the bottleneck)
+    double write_stall_seconds = 0.0;   // Writer waiting for data (device is the bottleneck)
+    uint64_t resumed_from = 0;          // Offset a resumed download continued from (bytes kept, if split)
+    bool completed = false;             // Set per file by batch downloads
+    std::string content_hash;           // XXH3-128 of the file in hex, empty if not computed
+};
+
+struct transfer_request {
+    std::string source_path;        // Remote path
+    std::string destination_path;   // Local path
+};
+
+struct range_read {
+    std::string path;               // Remote path
+    uint64_t offset = 0;
+    uint32_t length = 0;            // Bytes wanted, fewer are returned at end of file
+    std::vector<char> data;         // Filled in by read_ranges
+    bool completed = false;
+};
+
+struct mirror_options {
+    bool prune_deleted = false;     // Delete local copies of files removed from the device
+};
+
+struct archive_options {
+    int compression_level = 0;          // zstd level, 0 writes a plain tar
+    unsigned compression_threads = 0;   // zstd worker threads, 0 = one per core
 };
 
+struct mirror_stats {
+    uint64_t files_checked = 0;
+    uint64_t files_transferred = 0;
+    uint64_t files_unchanged = 0;   // Skipped because size and mtime matched the manifest
+    uint64_t files_pruned = 0;
+    uint64_t listing_errors = 0;    // Listings or stats that failed; nothing is pruned then
+    uint64_t files_failed = 0;
+    uint64_t bytes_transferred = 0;
+    double elapsed_seconds = 0.0;
+};
+
+struct cache_stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t expirations = 0;   // Misses caused by an entry outliving its TTL
+    uint64_t evictions = 0;
+    uint64_t invalidations = 0;
+    size_t entries = 0;
+    size_t capacity = 0;
+};
+
+struct walk_stats {
+    uint64_t directories = 0;   // Directories listed
+    uint64_t entries = 0;       // Entries passed to the visitor
+    uint64_t errors = 0;        // Listings or stats that failed
+    uint64_t steals = 0;        // Work items taken from another worker's queue
+    unsigned workers = 0;
+    double elapsed_seconds = 0.0;
+};
+
+// What a tree walk visitor wants done after seeing an entry
+enum class walk_action {
+    descend,    // Keep going (and walk into the entry if it is a directory)
+    prune,      // Do not walk into this directory
+    stop        // End the whole walk
+};
+
+// Called once per entry with its depth below the walk root (1 = direct child)
+typedef std::function<walk_action(const file_info& entry, unsigned depth)> walk_visitor;
+
+class file_info_cache;
+
 class afc_manager {
 private:
     idevice_t device;
@@ -22,10 +124,37 @@ private:
     afc_client_t afc_client;
     lockdownd_service_descriptor_t service;
     bool afc_connected;
+    unsigned parallel_connections;  // AFC connections used by parallel downloads
+    uint32_t initial_chunk_size;    // First request size of adaptive transfers
+    uint32_t max_chunk_size;        // Upper bound for adaptive transfers
+    bool resume_downloads;          // Keep a journal so interrupted downloads can continue
+    afc_client_pool* client_pool;   // Extra connections for worker threads, created on demand
+    std::mutex pool_lock;
+    file_info_cache* metadata_cache;  // Optional, nullptr when disabled
 
     // Helper methods
     std::string format_file_size(uint64_t size);
     file_info parse_file_info(const std::string& path, char** file_info_list);
+    bool read_chunk(afc_client_t client, uint64_t handle, uint64_t position, char* buffer,
+                    uint32_t limit, chunk_sizer& sizer, uint32_t* bytes_read);
+    bool write_chunk(afc_client_t client, uint64_t handle, uint64_t position, const char* data,
+                     uint32_t length, chunk_sizer& sizer);
+    bool pipelined_read(afc_client_t client, uint64_t handle, uint64_t start_offset,
+                        const std::function<bool(const char*, uint32_t)>& write_stage,
+                        transfer_stats* stats);
+    void invalidate_cached_info(const std::string& path, bool whole_tree);
+    file_info query_file_info(afc_client_t client, const std::string& path);
+    bool download_on_client(afc_client_t client, const std::string& source_path,
+                            const std::string& destination_path, transfer_stats* stats);
+    bool stream_on_client(afc_client_t client, const std::string& path, afc_read_sink& sink,
+                          uint64_t offset, transfer_stats* stats);
+    bool upload_on_client(afc_client_t client, const std::string& source_path,
+                          const std::string& destination_path, uint64_t file_size);
+    bool read_range_on_client(afc_client_t client, const std::string& path, uint64_t offset,
+                              uint32_t length, std::vector<char>& data);
+    bool copy_on_client(afc_client_t client, const std::string& source_path,
+                        const std::string& destination_path);
+    bool run_on_pool(size_t task_count, const std::function<bool(afc_client_t, size_t)>& task);
 
 public:
     afc_manager();
@@ -36,20 +165,53 @@ public:
     void disconnect();
 
     // Directory operations
-    std::vector<std::string> list_directory(const std::string& path);
+    std::vector<std::string> list_directory(const std::string& path, bool* listed = nullptr);
+    std::vector<file_info> list_directory_with_info(const std::string& path, bool* complete = nullptr);
+    bool walk_tree(const std::string& root, const walk_visitor& visitor, walk_stats* stats = nullptr);
     bool create_directory(const std::string& path);
     bool remove_path(const std::string& path);
+    bool remove_tree(const std::string& path);
+    bool move_path(const std::string& source_path, const std::string& destination_path);
+    bool copy_tree(const std::string& source_path, const std::string& destination_path);
 
     // File operations
-    bool download_file(const std::string& source_path, const std::string& destination_path);
+    bool download_file(const std::string& source_path, const std::string& destination_path,
+                       transfer_stats* stats = nullptr);
+    bool read_stream(const std::string& path, afc_read_sink& sink, uint64_t offset = 0,
+                     transfer_stats* stats = nullptr);
+    bool read_range(const std::string& path, uint64_t offset, uint32_t length, std::vector<char>& data);
+    bool read_ranges(std::vector<range_read>& reads);
     bool upload_file(const std::string& source_path, const std::string& destination_path);
+    bool upload_tree(const std::string& source_path, const std::string& destination_path,
+                     transfer_stats* stats = nullptr);
     bool file_exists(const std::string& path);
     file_info get_file_info(const std::string& path);
+    bool download_file_parallel(const std::string& source_path, const std::string& destination_path,
+                                transfer_stats* stats = nullptr);
+    bool download_files(const std::vector<transfer_request>& requests,
+                        std::vector<transfer_stats>* results = nullptr);
+    bool export_tar(const std::string& remote_root, int output_fd,
+                    const archive_options& options = archive_options(), transfer_stats* stats = nullptr);
+    bool mirror_directory(const std::string& remote_root, const std::string& local_root,
+                          const mirror_options& options = mirror_options(), mirror_stats* stats = nullptr);
 
     // Utility methods
     bool is_connected() const;
     void print_file_list(const std::vector<std::string>& files);
     afc_client_t get_afc_client() const;
+    afc_client_pool* get_client_pool();
+
+    // Metadata cache
+    void enable_metadata_cache(size_t max_entries, unsigned ttl_ms);
+    void disable_metadata_cache();
+    cache_stats get_cache_stats();
+
+    // Transfer settings
+    void set_parallel_connections(unsigned count);
+    unsigned get_parallel_connections() const;
+    void set_initial_chunk_size(uint32_t bytes);
+    void set_max_chunk_size(uint32_t bytes);
+    void set_resume_downloads(bool enabled);
 };
 
 #endif // AFC_MANAGER_H
@@ -0,0 +1,64 @@
+#ifndef AFC_READ_SINK_H
+#define AFC_READ_SINK_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+// Receives a remote file as consecutive chunks. The data pointer is only valid
+// during the call; a consume that blocks holds back the device reads
+class afc_read_sink {
+public:
+    virtual ~afc_read_sink() {}
+
+    virtual bool begin(const std::string& source_path, uint64_t offset);
+    virtual bool consume(const char* data, size_t length) = 0;
+    virtual bool finish(bool success);
+};
+
+// Writes the stream to a local file, keeping the existing prefix when starting past offset 0
+class file_sink : public afc_read_sink {
+private:
+    std::string path;
+    std::ofstream outfile;
+    uint64_t position;
+
+public:
+    explicit file_sink(const std::string& destination_path);
+
+    bool begin(const std::string& source_path, uint64_t offset) override;
+    bool consume(const char* data, size_t length) override;
+    bool finish(bool success) override;
+    bool flush();
+    uint64_t bytes_on_disk() const;
+};
+
+// Collects the stream in memory
+class memory_sink : public afc_read_sink {
+private:
+    std::vector<char> buffer;
+    size_t max_bytes;   // consume fails beyond this
+
+public:
+    explicit memory_sink(size_t limit = static_cast<size_t>(-1));
+
+    bool begin(const std::string& source_path, uint64_t offset) override;
+    bool consume(const char* data, size_t length) override;
+    std::vector<char>& data();
+};
+
+// Passes each chunk to a callback; returning false stops the read
+class function_sink : public afc_read_sink {
+private:
+    std::function<bool(const char*, size_t)> consumer;
+
+public:
+    explicit function_sink(const std::function<bool(const char*, size_t)>& callback);
+
+    bool consume(const char* data, size_t length) override;
+};
+
+#endif // AFC_READ_SINK_H
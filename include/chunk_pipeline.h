@@ -0,0 +1,48 @@
+#ifndef CHUNK_PIPELINE_H
+#define CHUNK_PIPELINE_H
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+
+struct pipeline_buffer {
+    std::vector<char> data;
+    uint32_t length;    // Valid bytes in data
+    uint64_t offset;    // Position of the first byte in the source
+};
+
+class chunk_pipeline {
+private:
+    std::vector<pipeline_buffer> buffers;
+    std::deque<pipeline_buffer*> free_buffers;
+    std::deque<pipeline_buffer*> filled_buffers;
+    std::mutex lock;
+    std::condition_variable free_available;
+    std::condition_variable filled_available;
+    bool producer_finished;
+    bool cancelled;
+    double producer_wait_seconds;
+    double consumer_wait_seconds;
+
+public:
+    chunk_pipeline(size_t buffer_count, size_t buffer_size);
+
+    // Producer side
+    pipeline_buffer* acquire();
+    void submit(pipeline_buffer* buffer);
+    void finish();
+
+    // Consumer side
+    pipeline_buffer* next();
+    void release(pipeline_buffer* buffer);
+
+    // Either side
+    void cancel();
+    bool is_cancelled();
+    double producer_wait() const;
+    double consumer_wait() const;
+};
+
+#endif // CHUNK_PIPELINE_H
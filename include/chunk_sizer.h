@@ -0,0 +1,26 @@
+#ifndef CHUNK_SIZER_H
+#define CHUNK_SIZER_H
+
+#include <cstdint>
+
+class chunk_sizer {
+private:
+    uint32_t current_size;
+    uint32_t min_size;
+    uint32_t max_size;
+    unsigned consecutive_failures;
+
+public:
+    chunk_sizer(uint32_t initial_size, uint32_t maximum_size);
+
+    // Feedback from completed requests
+    void record_success(uint32_t requested, uint32_t transferred, double elapsed_ms);
+    void record_failure();
+
+    // Sizing queries
+    uint32_t next_size() const;
+    uint32_t maximum() const;
+    bool should_give_up() const;
+};
+
+#endif // CHUNK_SIZER_H
@@ -0,0 +1,30 @@
+#ifndef CONTENT_HASHER_H
+#define CONTENT_HASHER_H
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <xxhash.h>
+
+// Streaming XXH3-128 digest of file contents, fed chunk by chunk as data arrives
+class content_hasher {
+private:
+    XXH3_state_t* state;
+    uint64_t bytes_hashed;
+
+public:
+    content_hasher();
+    ~content_hasher();
+    content_hasher(const content_hasher&) = delete;
+    content_hasher& operator=(const content_hasher&) = delete;
+
+    void reset();
+    void update(const char* data, size_t length);
+    bool update_from_file(const std::string& path, uint64_t length);
+
+    // Results
+    std::string hex_digest() const;
+    uint64_t size() const;
+};
+
+#endif // CONTENT_HASHER_H
@@ -0,0 +1,43 @@
+#ifndef FILE_INFO_CACHE_H
+#define FILE_INFO_CACHE_H
+
+#include <string>
+#include <list>
+#include <mutex>
+#include <chrono>
+#include <unordered_map>
+#include "afc_manager.h"
+
+class file_info_cache {
+private:
+    struct cache_entry {
+        std::string path;
+        bool exists;
+        file_info info;
+        std::chrono::steady_clock::time_point stored_at;
+    };
+
+    std::list<cache_entry> entries;  // Most recently used first
+    std::unordered_map<std::string, std::list<cache_entry>::iterator> index;
+    size_t capacity;
+    std::chrono::milliseconds ttl;
+    cache_stats stats;
+    std::mutex lock;
+
+public:
+    file_info_cache(size_t max_entries, unsigned ttl_ms);
+
+    // Cache access
+    bool lookup(const std::string& path, bool& exists, file_info& info);
+    void store(const std::string& path, bool exists, const file_info& info);
+
+    // Invalidation
+    void invalidate(const std::string& path);
+    void invalidate_tree(const std::string& path);
+    void clear();
+
+    // Utility methods
+    cache_stats get_stats();
+};
+
+#endif // FILE_INFO_CACHE_H
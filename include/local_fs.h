@@ -0,0 +1,31 @@
+#ifndef LOCAL_FS_H
+#define LOCAL_FS_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+struct local_file_info {
+    bool exists = false;
+    bool is_directory = false;
+    bool is_symlink = false;    // Only reported by link_stat
+    uint64_t file_size = 0;
+    int64_t modified_time = 0;  // Seconds since the epoch
+};
+
+// Thin portable wrappers over the local filesystem (MSYS2/Windows and POSIX)
+namespace local_fs {
+    local_file_info stat_path(const std::string& path);
+    local_file_info link_stat(const std::string& path);
+    bool make_directories(const std::string& path);
+    bool remove_file(const std::string& path);
+    bool remove_directory(const std::string& path);
+    bool rename_replace(const std::string& from, const std::string& to);
+    bool make_hard_link(const std::string& target, const std::string& link_path);
+    bool set_modified_time(const std::string& path, int64_t seconds);
+    std::vector<std::string> list_directory(const std::string& path);
+    std::string join_path(const std::string& directory, const std::string& name);
+    std::string parent_path(const std::string& path);
+}
+
+#endif // LOCAL_FS_H
@@ -0,0 +1,87 @@
+#ifndef MEDIA_METADATA_H
+#define MEDIA_METADATA_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+// Embedded preview image of a media file, located but not read
+struct media_preview {
+    std::string format;             // "jpeg", or "hvc1" for an HEVC-coded HEIF thumbnail; empty if none
+    uint64_t config_offset = 0;     // hvcC decoder configuration, hvc1 only
+    uint32_t config_length = 0;
+    uint64_t data_offset = 0;
+    uint32_t data_length = 0;
+};
+
+// Capture details read from the headers of a media file
+struct media_metadata {
+    int64_t capture_time = 0;       // Seconds since the epoch, 0 if unknown. EXIF times
+                                    // without a recorded offset are the camera's wall clock
+    uint32_t width = 0;
+    uint32_t height = 0;
+    double duration_seconds = 0.0;  // Videos only
+    media_preview preview;
+};
+
+// The parts of a remote file fetched so far by ranged reads
+class media_bytes {
+private:
+    uint64_t file_size;
+    std::map<uint64_t, std::vector<char> > chunks;  // Keyed by file offset
+
+public:
+    explicit media_bytes(uint64_t total_size);
+
+    void add(uint64_t offset, std::vector<char>& data);  // Takes over the contents of data
+    const char* find(uint64_t offset, uint64_t length) const;
+    uint64_t size() const;
+};
+
+enum class metadata_status {
+    complete,       // Everything available has been parsed
+    need_range      // Fetch next_request() and parse again
+};
+
+struct metadata_request {
+    uint64_t offset = 0;
+    uint32_t length = 0;
+};
+
+// Parses JPEG/EXIF, HEIF and QuickTime/MP4 headers out of whatever bytes of
+// a file have been fetched, and locates any embedded preview. Parsing is restartable: when a box or segment
+// lies outside the fetched ranges, parse asks for it and is simply run again
+// once it has been added
+class media_metadata_parser {
+private:
+    struct box_info {
+        uint64_t start;
+        uint64_t size;          // Including the header
+        uint32_t header_size;
+        char type[4];
+    };
+
+    const media_bytes& bytes;
+    metadata_request request;
+    bool has_request;
+
+    // Data access
+    const char* need(uint64_t offset, uint64_t length);
+    bool read_box(uint64_t position, uint64_t end, box_info& box);
+
+    // Container formats
+    void parse_jpeg(media_metadata& metadata);
+    void parse_bmff(media_metadata& metadata);
+    void parse_heif_meta(uint64_t start, uint64_t end, media_metadata& metadata);
+    void parse_movie(uint64_t start, uint64_t end, media_metadata& metadata);
+    void parse_exif(const char* tiff, size_t length, uint64_t position, media_metadata& metadata);
+
+public:
+    explicit media_metadata_parser(const media_bytes& file_bytes);
+
+    metadata_status parse(media_metadata& metadata);
+    metadata_request next_request() const;
+};
+
+#endif // MEDIA_METADATA_H
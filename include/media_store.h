@@ -0,0 +1,67 @@
+#ifndef MEDIA_STORE_H
+#define MEDIA_STORE_H
+
+#include <string>
+#include <map>
+#include <cstdint>
+#include <cstddef>
+
+// What the store knows about one file of a device tree
+struct store_entry {
+    std::string content_hash;   // XXH3-128 of the contents in hex
+    uint64_t file_size = 0;
+    uint64_t modified_time = 0; // Remote mtime (ns)
+};
+
+// Device tree manifest, keyed by path relative to the device root
+typedef std::map<std::string, store_entry> store_manifest;
+
+struct store_stats {
+    uint64_t files_checked = 0;
+    uint64_t files_unchanged = 0;       // Same size and mtime as the device manifest
+    uint64_t files_deduplicated = 0;    // Matched a stored object, contents not downloaded
+    uint64_t files_downloaded = 0;
+    uint64_t files_failed = 0;
+    uint64_t listing_errors = 0;        // Listings or stats that failed; manifest entries are kept then
+    uint64_t bytes_downloaded = 0;      // Including the probe reads
+    uint64_t bytes_deduplicated = 0;
+    double elapsed_seconds = 0.0;
+};
+
+// Local content-addressed store shared by several devices. Every distinct
+// file is kept once under objects/ by its content hash; each device gets a
+// manifest and a tree of hard links into the objects. A probe index maps the
+// size and a hash of the first and last bytes of a file to its content hash,
+// so known files can be recognised without downloading them
+class media_store {
+private:
+    std::string root;
+    std::map<std::string, std::string> probes;  // "size:probe hash" -> content hash
+    bool probes_modified;
+
+public:
+    explicit media_store(const std::string& root_path);
+
+    // Persistence
+    bool open();
+    bool save();
+
+    // Probe index
+    std::string find_probe(uint64_t file_size, const std::string& probe_hash) const;
+    void record_probe(uint64_t file_size, const std::string& probe_hash, const std::string& content_hash);
+
+    // Objects
+    std::string object_path(const std::string& content_hash) const;
+    bool has_object(const std::string& content_hash) const;
+    bool add_file(const std::string& path, const std::string& content_hash);
+    bool add_data(const char* data, size_t length, const std::string& content_hash);
+
+    // Device trees
+    std::string device_root(const std::string& device_id) const;
+    std::string temp_path(const std::string& name) const;
+    bool link_into(const std::string& content_hash, const std::string& tree_path);
+    store_manifest load_manifest(const std::string& device_id) const;
+    bool save_manifest(const std::string& device_id, const store_manifest& manifest) const;
+};
+
+#endif // MEDIA_STORE_H
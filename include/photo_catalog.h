@@ -0,0 +1,43 @@
+#ifndef PHOTO_CATALOG_H
+#define PHOTO_CATALOG_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <cstdint>
+#include "afc_manager.h"
+
+// One directory listing as recorded by the catalog
+struct catalog_directory {
+    uint64_t modified_time = 0;     // Directory mtime (ns) when it was listed
+    std::vector<file_info> entries;
+};
+
+// Persistent per-device record of the media directory listings. Stored as a
+// fixed-layout little-endian file that is memory-mapped when loaded
+class photo_catalog {
+private:
+    std::string catalog_path;
+    std::map<std::string, catalog_directory> directories;
+    bool modified;  // Needs saving
+
+public:
+    explicit photo_catalog(const std::string& path);
+
+    // Persistence
+    bool load();
+    bool save();
+
+    // Directory records
+    const catalog_directory* find(const std::string& directory) const;
+    void store(const std::string& directory, uint64_t modified_time, const std::vector<file_info>& entries);
+    void retain(const std::set<std::string>& directories_seen);
+
+    // Utility methods
+    const std::map<std::string, catalog_directory>& all_directories() const;
+    size_t entry_count() const;
+    const std::string& path() const;
+};
+
+#endif // PHOTO_CATALOG_H
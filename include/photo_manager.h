@@ -3,27 +3,92 @@
 
 #include <string>
 #include <vector>
+#include <set>
+#include <functional>
 #include "afc_manager.h"
+#include "photo_catalog.h"
+#include "media_store.h"
+#include "media_metadata.h"
+#include "thumbnail_cache.h"
 
 struct photo_info {
     std::string filename;
     std::string full_path;
     uint64_t file_size;
-    std::string modified_time;
+    uint64_t modified_time;  // Nanoseconds since the epoch, 0 if unknown
     std::string file_type;  // jpg, png, heic, etc.
+
+    // Filled in by load_metadata
+    int64_t capture_time = 0;       // Seconds since the epoch, 0 if unknown
+    uint32_t width = 0;
+    uint32_t height = 0;
+    double duration_seconds = 0.0;  // Videos only
+};
+
+// What a DCIM file holds, decided from its extension
+enum class media_kind : uint8_t {
+    other,
+    photo,
+    video,
+    sidecar     // Edit or metadata file such as .AAE
+};
+
+// A photo or video together with the files that belong to it: the movie of
+// a Live Photo, edited renders and sidecars (IMG_E1234.HEIC, IMG_E1234.AAE)
+// sharing its base name within one directory
+struct media_asset {
+    std::string directory;
+    std::string base_name;                  // IMG_1234
+    media_kind kind = media_kind::other;    // photo or video; sidecar if nothing else was found
+    bool live_photo = false;                // A photo with its movie
+    std::vector<photo_info> components;     // Primary file first, then by filename
+    uint64_t total_bytes = 0;
+};
+
+// Result of one classified traversal of a media folder
+struct media_scan {
+    std::vector<photo_info> photos;
+    std::vector<photo_info> videos;         // Standalone videos only
+    std::vector<photo_info> live_videos;    // Movie halves of Live Photos
+    std::vector<photo_info> sidecars;
+    std::vector<media_asset> assets;        // Every file above, grouped
+    uint64_t photo_bytes = 0;
+    uint64_t video_bytes = 0;
+    uint64_t live_video_bytes = 0;
+    uint64_t sidecar_bytes = 0;
+    uint64_t other_files = 0;   // Files of no known media type
+    uint64_t errors = 0;        // Listings or stats that failed
+    bool complete = false;      // Root and every folder under it were listed
 };
 
+// Called once per photo, on the thread that called for_each_photo, soon
+// after the walk has stat'ed it; returning false cancels the enumeration.
+// The walk holds the pooled AFC connections until it ends, so single-file
+// downloads from the visitor use the primary connection, and batch
+// transfers (download_files, backup_photos, ...) must wait until
+// for_each_photo returns
+typedef std::function<bool(const photo_info& photo)> photo_visitor;
+
 class photo_manager {
 private:
     afc_manager* afc;
     bool owns_afc;  // Track if we created the afc_manager
+    photo_catalog* catalog;  // nullptr until open_catalog succeeds
 
     // Helper methods
+    media_kind classify_media(const std::string& filename);
     bool is_photo_file(const std::string& filename);
     bool is_video_file(const std::string& filename);
     std::string get_file_extension(const std::string& filename);
-    void scan_for_photos(const std::string& path, std::vector<photo_info>& photos);
+    void add_to_scan(const file_info& finfo, media_scan& scan);
+    void group_assets(media_scan& scan);
     photo_info file_info_to_photo_info(const file_info& finfo);
+    bool refresh_catalog(const std::string& root, uint64_t* errors = nullptr);
+    void refresh_directory(const std::string& path, uint64_t modified_time,
+                           std::set<std::string>& seen, size_t& relisted, uint64_t& errors);
+    size_t read_headers(std::vector<photo_info>& items, size_t begin, size_t end,
+                        std::vector<media_bytes>& fetched, std::vector<media_metadata>& results,
+                        std::vector<bool>& failed, uint64_t& bytes_read);
 
 public:
     photo_manager();
@@ -33,20 +98,31 @@ public:
     // Connection methods
     bool connect(idevice_t dev, lockdownd_client_t lockdown);
     void disconnect();
+    bool open_catalog(const std::string& device_id, const std::string& directory = "");
 
     // Photo listing operations
+    media_scan scan_media(const std::string& root = "/DCIM", bool use_catalog = true);
     std::vector<photo_info> list_all_photos();
+    bool for_each_photo(const photo_visitor& visitor, const std::string& root = "/DCIM",
+                        walk_stats* stats = nullptr);
     std::vector<photo_info> list_photos_in_folder(const std::string& folder_path);
     std::vector<photo_info> list_videos();
+    bool load_metadata(std::vector<photo_info>& items);
 
     // Photo operations
     bool download_photo(const std::string& photo_path, const std::string& destination);
     bool download_all_photos(const std::string& destination_folder);
+    bool backup_photos(const std::string& destination_root, mirror_stats* stats = nullptr);
+    bool store_photos(media_store& store, const std::string& device_id, store_stats* stats = nullptr);
+    bool cache_thumbnails(const std::vector<photo_info>& items, thumbnail_cache& cache,
+                          thumbnail_stats* stats = nullptr);
+    bool archive_all_photos(int output_fd, const archive_options& options);
     int get_photo_count();
     int get_video_count();
 
     // Utility methods
     void print_photo_list(const std::vector<photo_info>& photos);
+    void sort_by_capture_time(std::vector<photo_info>& photos);
     bool is_connected() const;
 };
 
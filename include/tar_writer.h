@@ -0,0 +1,48 @@
+#ifndef TAR_WRITER_H
+#define TAR_WRITER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <zstd.h>
+
+// Streams a POSIX (ustar + pax) tar archive to a file descriptor, optionally zstd compressed
+class tar_writer {
+private:
+    int fd;
+    ZSTD_CCtx* compressor;          // nullptr when writing a plain tar
+    std::vector<char> output;       // Staging buffer for the descriptor
+    size_t output_used;             // Pending plain bytes in output
+    uint64_t entry_remaining;       // Data bytes still expected for the open file entry
+    uint64_t entry_written;         // Data bytes written to the open file entry
+    bool entry_overflow;            // More data arrived than the open entry announced
+    uint64_t bytes_out;             // Bytes written to fd
+    bool failed;
+
+    // Helper methods
+    bool write_header(const std::string& name, char type, uint64_t size, uint64_t mtime, unsigned mode);
+    bool write_pax_header(const std::string& name, uint64_t size);
+    bool emit(const char* data, size_t length);
+    bool emit_zeros(size_t length);
+    bool flush_output();
+
+public:
+    tar_writer(int output_fd, int compression_level, unsigned compression_threads);
+    ~tar_writer();
+    tar_writer(const tar_writer&) = delete;
+    tar_writer& operator=(const tar_writer&) = delete;
+
+    // Entries
+    bool add_directory(const std::string& name, uint64_t mtime);
+    bool begin_file(const std::string& name, uint64_t size, uint64_t mtime);
+    bool write_data(const char* data, size_t length);
+    bool end_file();
+    bool finish();
+
+    // Status
+    uint64_t bytes_written() const;
+    bool good() const;
+};
+
+#endif // TAR_WRITER_H
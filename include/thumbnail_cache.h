@@ -0,0 +1,69 @@
+#ifndef THUMBNAIL_CACHE_H
+#define THUMBNAIL_CACHE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include <cstdint>
+
+// An embedded preview as stored in the cache
+struct thumbnail {
+    std::string format;         // "jpeg", or "hvc1" for an HEVC-coded HEIF thumbnail
+    std::vector<char> config;   // hvcC decoder configuration, hvc1 only
+    std::vector<char> data;
+};
+
+struct thumbnail_stats {
+    uint64_t files_checked = 0;
+    uint64_t files_cached = 0;          // Already in the cache for the same mtime
+    uint64_t thumbnails_extracted = 0;
+    uint64_t files_without_thumbnail = 0;
+    uint64_t files_failed = 0;
+    uint64_t bytes_downloaded = 0;      // Headers and previews
+    double elapsed_seconds = 0.0;
+};
+
+// Single-file cache of embedded previews keyed by device path and mtime.
+// Records are appended as they are added; the file is rewritten without
+// superseded records once those make up most of it. Files found to have no
+// preview are recorded too, so they are not probed again
+class thumbnail_cache {
+private:
+    struct cache_entry {
+        uint64_t modified_time;
+        uint64_t offset;            // Of the record's config bytes in the file
+        uint32_t config_length;
+        uint32_t data_length;
+        std::string format;         // Empty when the file has no preview
+    };
+
+    std::string cache_path;
+    std::map<std::string, cache_entry> entries;
+    std::string pending;            // Records added since the last save
+    uint64_t file_length;           // Bytes of the cache file on disk
+    uint64_t live_bytes;            // Record bytes still referenced by entries
+    bool rewrite;                   // File is missing or damaged; write it whole
+
+    const cache_entry* lookup(const std::string& path, uint64_t modified_time) const;
+    bool read_entry(std::ifstream& in, const cache_entry& entry, thumbnail& preview) const;
+    bool compact();
+
+public:
+    explicit thumbnail_cache(const std::string& path);
+
+    // Persistence
+    bool load();
+    bool save();
+
+    // Previews
+    bool contains(const std::string& path, uint64_t modified_time) const;
+    bool find(const std::string& path, uint64_t modified_time, thumbnail& preview) const;
+    void store(const std::string& path, uint64_t modified_time, const thumbnail& preview);
+
+    // Utility methods
+    size_t size() const;
+    const std::string& path() const;
+};
+
+#endif // THUMBNAIL_CACHE_H
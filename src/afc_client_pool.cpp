@@ -0,0 +1,499 @@
+#include "afc_client_pool.h"
+#include <iostream>
+
+// Clients idle for longer than this are pinged before they are lent out
+static const std::chrono::seconds idle_check_interval(30);
+
+/*****************************************************************************/
+/* Function Name: afc_client_pool (Constructor)                              */
+/*                                                                           */
+/* Description: Prepares a pool of AFC clients for one device and lockdown   */
+/*              session. No services are started until open is called        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+afc_client_pool::afc_client_pool(idevice_t dev, lockdownd_client_t lockdown, size_t size)
+    : device(dev), lockdown_client(lockdown), clients(size == 0 ? 1 : size), pool_open(false)
+{
+    for (auto& entry : clients)
+    {
+        entry.client = nullptr;
+        entry.service = nullptr;
+        entry.in_use = false;
+        entry.healthy = false;
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: ~afc_client_pool (Destructor)                              */
+/*                                                                           */
+/* Description: Closes every pooled connection                               */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+afc_client_pool::~afc_client_pool()
+{
+    close();
+}
+
+/*****************************************************************************/
+/* Function Name: open                                                       */
+/*                                                                           */
+/* Description: Starts one com.apple.afc service instance per pool slot.     */
+/*              Succeeds if at least one client could be created; slots      */
+/*              that failed are retried when they are next lent out          */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool afc_client_pool::open()
+{
+    if (!device || !lockdown_client)
+    {
+        std::cerr << "Error: Invalid device or lockdown client." << std::endl;
+        return false;
+    }
+
+    size_t started = 0;
+    for (auto& entry : clients)
+    {
+        if (start_client(entry))
+        {
+            started++;
+        }
+    }
+
+    if (started == 0)
+    {
+        std::cerr << "Error: Failed to start any pooled AFC connection." << std::endl;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        pool_open = true;
+    }
+    available.notify_all();
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: close                                                      */
+/*                                                                           */
+/* Description: Waits for outstanding leases to come back and frees every    */
+/*              pooled connection                                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void afc_client_pool::close()
+{
+    std::unique_lock<std::mutex> guard(lock);
+    pool_open = false;
+    available.notify_all();
+
+    available.wait(guard, [this]()
+    {
+        for (const auto& entry : clients)
+        {
+            if (entry.in_use)
+            {
+                return false;
+            }
+        }
+        return true;
+    });
+
+    for (auto& entry : clients)
+    {
+        stop_client(entry);
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: start_client                                               */
+/*                                                                           */
+/* Description: Starts an AFC service instance and creates its client        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool afc_client_pool::start_client(pooled_client& entry)
+{
+    std::lock_guard<std::mutex> guard(service_lock);
+
+    entry.healthy = false;
+    if (lockdownd_start_service(lockdown_client, "com.apple.afc", &entry.service) != LOCKDOWN_E_SUCCESS)
+    {
+        entry.service = nullptr;
+        return false;
+    }
+
+    if (afc_client_new(device, entry.service, &entry.client) != AFC_E_SUCCESS)
+    {
+        lockdownd_service_descriptor_free(entry.service);
+        entry.service = nullptr;
+        entry.client = nullptr;
+        return false;
+    }
+
+    entry.healthy = true;
+    entry.last_used = std::chrono::steady_clock::now();
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: stop_client                                                */
+/*                                                                           */
+/* Description: Frees a pooled client and its service descriptor             */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void afc_client_pool::stop_client(pooled_client& entry)
+{
+    if (entry.client)
+    {
+        afc_client_free(entry.client);
+        entry.client = nullptr;
+    }
+
+    if (entry.service)
+    {
+        lockdownd_service_descriptor_free(entry.service);
+        entry.service = nullptr;
+    }
+
+    entry.healthy = false;
+}
+
+/*****************************************************************************/
+/* Function Name: check_client                                               */
+/*                                                                           */
+/* Description: Pings a client that failed or sat idle and reconnects it if  */
+/*              the device no longer answers on it                           */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool afc_client_pool::check_client(pooled_client& entry)
+{
+    bool idle = std::chrono::steady_clock::now() - entry.last_used > idle_check_interval;
+
+    if (entry.client && entry.healthy && !idle)
+    {
+        return true;
+    }
+
+    if (entry.client)
+    {
+        char** info = nullptr;
+        if (afc_get_device_info(entry.client, &info) == AFC_E_SUCCESS)
+        {
+            afc_dictionary_free(info);
+            entry.healthy = true;
+            return true;
+        }
+    }
+
+    stop_client(entry);
+    return start_client(entry);
+}
+
+/*****************************************************************************/
+/* Function Name: acquire                                                    */
+/*                                                                           */
+/* Description: Lends out a client, blocking until one is free. Returns an   */
+/*              empty lease if the pool is closed or no connection could be  */
+/*              re-established                                               */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+afc_client_pool::lease afc_client_pool::acquire()
+{
+    size_t index = 0;
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        bool found = false;
+
+        available.wait(guard, [&]()
+        {
+            if (!pool_open)
+            {
+                return true;
+            }
+            for (size_t i = 0; i < clients.size(); i++)
+            {
+                if (!clients[i].in_use)
+                {
+                    index = i;
+                    found = true;
+                    return true;
+                }
+            }
+            return false;
+        });
+
+        if (!found)
+        {
+            return lease();
+        }
+        clients[index].in_use = true;
+    }
+
+    // The slot is ours now, so the health check can run without the pool lock
+    if (!check_client(clients[index]))
+    {
+        std::cerr << "Error: Failed to reconnect pooled AFC connection." << std::endl;
+        give_back(index, true);
+        return lease();
+    }
+
+    return lease(this, index, clients[index].client);
+}
+
+/*****************************************************************************/
+/* Function Name: try_acquire                                                */
+/*                                                                           */
+/* Description: Lends out a client only if one is free right now             */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+afc_client_pool::lease afc_client_pool::try_acquire()
+{
+    size_t index = clients.size();
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (!pool_open)
+        {
+            return lease();
+        }
+
+        for (size_t i = 0; i < clients.size(); i++)
+        {
+            if (!clients[i].in_use)
+            {
+                index = i;
+                break;
+            }
+        }
+
+        if (index == clients.size())
+        {
+            return lease();
+        }
+        clients[index].in_use = true;
+    }
+
+    if (!check_client(clients[index]))
+    {
+        give_back(index, true);
+        return lease();
+    }
+
+    return lease(this, index, clients[index].client);
+}
+
+/*****************************************************************************/
+/* Function Name: give_back                                                  */
+/*                                                                           */
+/* Description: Returns a slot to the pool. Clients returned as failed are   */
+/*              checked before they are lent out again                       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void afc_client_pool::give_back(size_t index, bool failed)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        pooled_client& entry = clients[index];
+        entry.in_use = false;
+        entry.last_used = std::chrono::steady_clock::now();
+        if (failed)
+        {
+            entry.healthy = false;
+        }
+    }
+    available.notify_all();
+}
+
+/*****************************************************************************/
+/* Function Name: size                                                       */
+/*                                                                           */
+/* Description: Returns the number of pool slots                             */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+size_t afc_client_pool::size() const
+{
+    return clients.size();
+}
+
+/*****************************************************************************/
+/* Function Name: healthy_count                                              */
+/*                                                                           */
+/* Description: Returns the number of slots with a working connection        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+size_t afc_client_pool::healthy_count()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    size_t count = 0;
+    for (const auto& entry : clients)
+    {
+        if (entry.healthy)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/*****************************************************************************/
+/* Function Name: lease (Constructors)                                       */
+/*                                                                           */
+/* Description: Creates an empty lease or one holding a borrowed client      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+afc_client_pool::lease::lease()
+    : pool(nullptr), index(0), client(nullptr), failed(false)
+{
+}
+
+afc_client_pool::lease::lease(afc_client_pool* owner, size_t slot, afc_client_t borrowed)
+    : pool(owner), index(slot), client(borrowed), failed(false)
+{
+}
+
+/*****************************************************************************/
+/* Function Name: lease (Move operations)                                    */
+/*                                                                           */
+/* Description: Transfers ownership of a borrowed client between leases      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+afc_client_pool::lease::lease(lease&& other)
+    : pool(other.pool), index(other.index), client(other.client), failed(other.failed)
+{
+    other.pool = nullptr;
+    other.client = nullptr;
+}
+
+afc_client_pool::lease& afc_client_pool::lease::operator=(lease&& other)
+{
+    if (this != &other)
+    {
+        release();
+        pool = other.pool;
+        index = other.index;
+        client = other.client;
+        failed = other.failed;
+        other.pool = nullptr;
+        other.client = nullptr;
+    }
+    return *this;
+}
+
+/*****************************************************************************/
+/* Function Name: ~lease (Destructor)                                        */
+/*                                                                           */
+/* Description: Returns the borrowed client to the pool                      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+afc_client_pool::lease::~lease()
+{
+    release();
+}
+
+/*****************************************************************************/
+/* Function Name: get                                                        */
+/*                                                                           */
+/* Description: Returns the borrowed AFC client, or nullptr for an empty     */
+/*              lease                                                        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+afc_client_t afc_client_pool::lease::get() const
+{
+    return client;
+}
+
+/*****************************************************************************/
+/* Function Name: operator bool                                              */
+/*                                                                           */
+/* Description: Returns true if the lease holds a client                     */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+afc_client_pool::lease::operator bool() const
+{
+    return client != nullptr;
+}
+
+/*****************************************************************************/
+/* Function Name: mark_failed                                                */
+/*                                                                           */
+/* Description: Flags the client as suspect so the pool health-checks it     */
+/*              before lending it out again                                  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void afc_client_pool::lease::mark_failed()
+{
+    failed = true;
+}
+
+/*****************************************************************************/
+/* Function Name: release                                                    */
+/*                                                                           */
+/* Description: Returns the client to the pool before the lease goes out of  */
+/*              scope                                                        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void afc_client_pool::lease::release()
+{
+    if (pool)
+    {
+        pool->give_back(index, failed);
+        pool = nullptr;
+        client = nullptr;
+        failed = false;
+    }
+}
@@ -2,6 +2,494 @@
 #include <iostream>
 #include <fstream>
 #include <cstring>
+#include <cstdlib>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <condition_variable>
+#include "chunk_pipeline.h"
+#include "file_info_cache.h"
+#include "local_fs.h"
+#include "content_hasher.h"
+#include "tar_writer.h"
+
+// Files smaller than this per connection are not worth splitting into ranges
+static const uint64_t min_parallel_range_size = 4 * 1024 * 1024;
+
+// Buffers in flight between the AFC reader and the local writer, and the size
+// they start at before growing towards the maximum chunk size
+static const size_t pipeline_buffer_count = 4;
+static const uint32_t initial_buffer_size = 128 * 1024;
+
+// Directories with fewer entries than this are stat'ed on the primary connection
+static const size_t min_parallel_stat_entries = 8;
+
+// Entries stat'ed per tree walk work item, small enough for idle workers to steal
+static const size_t walk_batch_size = 16;
+
+// Resume journal kept next to a partial download, and how often it is updated
+static const char* const journal_suffix = ".afcjournal";
+static const uint64_t journal_commit_interval = 8 * 1024 * 1024;
+
+// Mirror manifest kept in the local root, and its format version
+static const char* const mirror_manifest_name = ".afcmirror";
+static const char* const mirror_manifest_header = "afcmirror 1";
+
+struct download_journal {
+    std::string remote_path;
+    uint64_t remote_size;
+    uint64_t remote_mtime;
+    uint64_t committed;
+    std::vector<std::pair<uint64_t, uint64_t> > ranges;  // Split downloads: next offset and end of each range
+};
+
+struct mirror_entry {
+    uint64_t remote_size;
+    uint64_t remote_mtime;
+};
+
+typedef std::map<std::string, mirror_entry> mirror_manifest;
+
+/*****************************************************************************/
+/* Function Name: join_remote_path                                           */
+/*                                                                           */
+/* Description: Appends an entry name to a remote directory path             */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static std::string join_remote_path(const std::string& directory, const std::string& name)
+{
+    std::string full_path = directory;
+    if (full_path.empty() || full_path.back() != '/')
+    {
+        full_path += "/";
+    }
+    full_path += name;
+    return full_path;
+}
+
+/*****************************************************************************/
+/* Function Name: parent_remote_path                                         */
+/*                                                                           */
+/* Description: Returns the directory containing a remote path               */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static std::string parent_remote_path(const std::string& path)
+{
+    size_t slash = path.find_last_of('/');
+    if (slash == std::string::npos || slash == 0)
+    {
+        return "/";
+    }
+    return path.substr(0, slash);
+}
+
+/*****************************************************************************/
+/* Function Name: normalize_remote_path                                      */
+/*                                                                           */
+/* Description: Returns a remote path in a canonical form so two spellings   */
+/*              of one location compare equal. AFC resolves paths from the   */
+/*              media root, so the result always starts with a slash; empty  */
+/*              and "." components are dropped and ".." removes its parent   */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static std::string normalize_remote_path(const std::string& path)
+{
+    std::vector<std::string> components;
+    size_t start = 0;
+    while (start <= path.size())
+    {
+        size_t slash = path.find('/', start);
+        if (slash == std::string::npos)
+        {
+            slash = path.size();
+        }
+
+        std::string component = path.substr(start, slash - start);
+        if (component == "..")
+        {
+            if (!components.empty())
+            {
+                components.pop_back();
+            }
+        }
+        else if (!component.empty() && component != ".")
+        {
+            components.push_back(component);
+        }
+        start = slash + 1;
+    }
+
+    std::string normalized;
+    for (const auto& component : components)
+    {
+        normalized += "/" + component;
+    }
+    return normalized.empty() ? "/" : normalized;
+}
+
+/*****************************************************************************/
+/* Function Name: parse_file_type                                            */
+/*                                                                           */
+/* Description: Maps the st_ifmt value of an AFC stat to afc_file_type       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static afc_file_type parse_file_type(const char* value)
+{
+    if (strncmp(value, "S_IF", 4) != 0)
+    {
+        return afc_file_type::unknown;
+    }
+
+    value += 4;
+    if (strcmp(value, "REG") == 0)
+    {
+        return afc_file_type::regular;
+    }
+    if (strcmp(value, "DIR") == 0)
+    {
+        return afc_file_type::directory;
+    }
+    if (strcmp(value, "LNK") == 0)
+    {
+        return afc_file_type::symlink;
+    }
+    if (strcmp(value, "CHR") == 0)
+    {
+        return afc_file_type::character_device;
+    }
+    if (strcmp(value, "BLK") == 0)
+    {
+        return afc_file_type::block_device;
+    }
+    if (strcmp(value, "IFO") == 0)
+    {
+        return afc_file_type::fifo;
+    }
+    if (strcmp(value, "SOCK") == 0)
+    {
+        return afc_file_type::socket;
+    }
+    return afc_file_type::unknown;
+}
+
+/*****************************************************************************/
+/* Function Name: load_journal                                               */
+/*                                                                           */
+/* Description: Reads the resume journal of a partial download. Returns      */
+/*              false if there is none or it cannot be parsed. Journals of   */
+/*              split downloads carry the progress of every range            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Numeric modification time           */
+/* 2026-10-16      S. Amalfitano         Ranges of split downloads           */
+/*****************************************************************************/
+static bool load_journal(const std::string& journal_path, download_journal& journal)
+{
+    std::ifstream infile(journal_path);
+    if (!infile.is_open())
+    {
+        return false;
+    }
+
+    std::getline(infile, journal.remote_path);
+    infile >> journal.remote_size >> journal.remote_mtime >> journal.committed;
+    if (infile.fail())
+    {
+        return false;
+    }
+
+    journal.ranges.clear();
+    std::string tag;
+    size_t count = 0;
+    if (infile >> tag >> count && tag == "ranges")
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            std::pair<uint64_t, uint64_t> range;
+            if (!(infile >> range.first >> range.second))
+            {
+                return false;
+            }
+            journal.ranges.push_back(range);
+        }
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: save_journal                                               */
+/*                                                                           */
+/* Description: Records how much of a download has been written to disk.     */
+/*              The journal is written to a temporary file and renamed over  */
+/*              the old one so a crash never leaves it half written          */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Use local_fs rename                 */
+/* 2026-10-16      S. Amalfitano         Ranges of split downloads           */
+/*****************************************************************************/
+static bool save_journal(const std::string& journal_path, const download_journal& journal)
+{
+    std::string temp_path = journal_path + ".tmp";
+    {
+        std::ofstream outfile(temp_path, std::ios::trunc);
+        if (!outfile.is_open())
+        {
+            return false;
+        }
+
+        outfile << journal.remote_path << "\n"
+                << journal.remote_size << "\n"
+                << journal.remote_mtime << "\n"
+                << journal.committed << "\n";
+        if (!journal.ranges.empty())
+        {
+            outfile << "ranges " << journal.ranges.size() << "\n";
+            for (const auto& range : journal.ranges)
+            {
+                outfile << range.first << " " << range.second << "\n";
+            }
+        }
+        if (!outfile.good())
+        {
+            return false;
+        }
+    }
+
+    return local_fs::rename_replace(temp_path, journal_path);
+}
+
+/*****************************************************************************/
+/* Function Name: load_manifest                                              */
+/*                                                                           */
+/* Description: Reads a mirror manifest. Each line after the header holds    */
+/*              the remote size, remote mtime and path relative to the       */
+/*              mirror root, separated by tabs. A missing or unreadable      */
+/*              manifest yields an empty one, which makes the next mirror a  */
+/*              full copy                                                    */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Numeric modification time           */
+/*****************************************************************************/
+static mirror_manifest load_manifest(const std::string& manifest_path)
+{
+    mirror_manifest manifest;
+
+    std::ifstream infile(manifest_path);
+    std::string line;
+    if (!infile.is_open() || !std::getline(infile, line) || line != mirror_manifest_header)
+    {
+        return manifest;
+    }
+
+    while (std::getline(infile, line))
+    {
+        size_t first_tab = line.find('\t');
+        size_t second_tab = (first_tab == std::string::npos) ? first_tab : line.find('\t', first_tab + 1);
+        if (second_tab == std::string::npos)
+        {
+            continue;
+        }
+
+        mirror_entry entry;
+        entry.remote_size = strtoull(line.c_str(), nullptr, 10);
+        entry.remote_mtime = strtoull(line.c_str() + first_tab + 1, nullptr, 10);
+        manifest[line.substr(second_tab + 1)] = entry;
+    }
+
+    return manifest;
+}
+
+/*****************************************************************************/
+/* Function Name: save_manifest                                              */
+/*                                                                           */
+/* Description: Writes a mirror manifest through a temporary file so an      */
+/*              interrupted run leaves the previous manifest intact          */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static bool save_manifest(const std::string& manifest_path, const mirror_manifest& manifest)
+{
+    std::string temp_path = manifest_path + ".tmp";
+    {
+        std::ofstream outfile(temp_path, std::ios::trunc);
+        if (!outfile.is_open())
+        {
+            return false;
+        }
+
+        outfile << mirror_manifest_header << "\n";
+        for (const auto& item : manifest)
+        {
+            outfile << item.second.remote_size << "\t" << item.second.remote_mtime << "\t" << item.first << "\n";
+        }
+        if (!outfile.good())
+        {
+            return false;
+        }
+    }
+
+    return local_fs::rename_replace(temp_path, manifest_path);
+}
+
+// Local file output of a download. Hashes the contents on the way through and
+// keeps the resume journal up to date when one is given
+class download_sink : public file_sink {
+private:
+    std::string destination;
+    std::string journal_path;
+    download_journal* journal;  // nullptr when resuming is disabled
+    content_hasher hasher;
+    bool hash_valid;
+
+public:
+    download_sink(const std::string& destination_path, download_journal* resume_journal);
+
+    bool begin(const std::string& source_path, uint64_t offset) override;
+    bool consume(const char* data, size_t length) override;
+    bool finish(bool success) override;
+    std::string digest() const;
+};
+
+/*****************************************************************************/
+/* Function Name: download_sink (Constructor)                                */
+/*                                                                           */
+/* Description: Prepares the local output of a download. resume_journal is   */
+/*              nullptr when resuming is disabled                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+download_sink::download_sink(const std::string& destination_path, download_journal* resume_journal)
+    : file_sink(destination_path), destination(destination_path), journal_path(destination_path + journal_suffix),
+      journal(resume_journal), hash_valid(true)
+{
+}
+
+/*****************************************************************************/
+/* Function Name: begin                                                      */
+/*                                                                           */
+/* Description: Opens the local file, records the journal and, when          */
+/*              resuming, folds the prefix from the earlier attempt into the */
+/*              digest                                                       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool download_sink::begin(const std::string& source_path, uint64_t offset)
+{
+    if (!file_sink::begin(source_path, offset))
+    {
+        return false;
+    }
+
+    if (journal && !save_journal(journal_path, *journal))
+    {
+        std::cerr << "Warning: Failed to write resume journal: " << journal_path << std::endl;
+    }
+
+    hasher.reset();
+    hash_valid = (offset == 0) || hasher.update_from_file(destination, offset);
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: consume                                                    */
+/*                                                                           */
+/* Description: Writes and hashes a chunk, committing the journal every      */
+/*              journal_commit_interval bytes                                */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool download_sink::consume(const char* data, size_t length)
+{
+    if (!file_sink::consume(data, length))
+    {
+        return false;
+    }
+
+    hasher.update(data, length);
+    if (journal && bytes_on_disk() - journal->committed >= journal_commit_interval && flush())
+    {
+        journal->committed = bytes_on_disk();
+        save_journal(journal_path, *journal);
+    }
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: finish                                                     */
+/*                                                                           */
+/* Description: Closes the file and settles the journal: removed after a     */
+/*              complete download, otherwise updated with everything that    */
+/*              reached the disk for the next attempt                        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool download_sink::finish(bool success)
+{
+    bool closed = file_sink::finish(true);
+
+    if (journal)
+    {
+        if (success && closed)
+        {
+            std::remove(journal_path.c_str());
+        }
+        else if (closed)
+        {
+            // Everything handed to the writer is on disk; record it for the next attempt
+            journal->committed = bytes_on_disk();
+            save_journal(journal_path, *journal);
+        }
+    }
+
+    return success && closed;
+}
+
+/*****************************************************************************/
+/* Function Name: digest                                                     */
+/*                                                                           */
+/* Description: Returns the XXH3 digest of the whole file, or an empty       */
+/*              string if the resumed prefix could not be hashed             */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+std::string download_sink::digest() const
+{
+    return hash_valid ? hasher.hex_digest() : std::string();
+}
 
 /*****************************************************************************/
 /* Function Name: afc_manager (Constructor)                                  */
@@ -14,7 +502,9 @@
 /*****************************************************************************/
 afc_manager::afc_manager()
     : device(nullptr), lockdown_client(nullptr), afc_client(nullptr),
-      service(nullptr), afc_connected(false)
+      service(nullptr), afc_connected(false), parallel_connections(4),
+      initial_chunk_size(1024 * 1024), max_chunk_size(4 * 1024 * 1024),
+      resume_downloads(true), client_pool(nullptr), metadata_cache(nullptr)
 {
 }
 
@@ -30,6 +520,7 @@ afc_manager::afc_manager()
 afc_manager::~afc_manager()
 {
     disconnect();
+    delete metadata_cache;
 }
 
 /*****************************************************************************/
@@ -93,9 +584,22 @@ bool afc_manager::connect_afc(idevice_t dev, lockdownd_client_t lockdown)
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Close the client pool               */
+/* 2026-10-16      S. Amalfitano         Drop cached metadata                */
 /*****************************************************************************/
 void afc_manager::disconnect()
 {
+    if (metadata_cache)
+    {
+        metadata_cache->clear();
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(pool_lock);
+        delete client_pool;
+        client_pool = nullptr;
+    }
+
     if (afc_client)
     {
         afc_client_free(afc_client);
@@ -114,15 +618,22 @@ void afc_manager::disconnect()
 /*****************************************************************************/
 /* Function Name: list_directory                                             */
 /*                                                                           */
-/* Description: Lists all files and directories in the specified path        */
+/* Description: Lists all files and directories in the specified path.       */
+/*              listed, if given, tells an empty directory from a failed     */
+/*              listing                                                      */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Report failed listings              */
 /*****************************************************************************/
-std::vector<std::string> afc_manager::list_directory(const std::string& path)
+std::vector<std::string> afc_manager::list_directory(const std::string& path, bool* listed)
 {
     std::vector<std::string> result;
+    if (listed)
+    {
+        *listed = false;
+    }
 
     if (!afc_connected)
     {
@@ -139,6 +650,11 @@ std::vector<std::string> afc_manager::list_directory(const std::string& path)
         return result;
     }
 
+    if (listed)
+    {
+        *listed = true;
+    }
+
     if (list)
     {
         for (int i = 0; list[i]; i++)
@@ -157,246 +673,2283 @@ std::vector<std::string> afc_manager::list_directory(const std::string& path)
 }
 
 /*****************************************************************************/
-/* Function Name: create_directory                                           */
+/* Function Name: list_directory_with_info                                   */
 /*                                                                           */
-/* Description: Creates a new directory on the device                        */
+/* Description: Lists a directory and returns every entry with its parsed    */
+/*              file information. The per-entry stat requests are spread     */
+/*              over the pooled AFC connections instead of being issued one  */
+/*              by one. Entries keep the order of the directory listing.     */
+/*              complete, if given, is cleared when the listing or any entry */
+/*              stat failed; such entries come back with an unknown type     */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
-/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Report incomplete listings          */
 /*****************************************************************************/
-bool afc_manager::create_directory(const std::string& path)
+std::vector<file_info> afc_manager::list_directory_with_info(const std::string& path, bool* complete)
 {
+    std::vector<file_info> result;
+    if (complete)
+    {
+        *complete = false;
+    }
+
     if (!afc_connected)
     {
-        std::cerr << "Error: AFC not connected." << std::endl;
-        return false;
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return result;
+    }
+
+    bool listed = false;
+    std::vector<std::string> entries = list_directory(path, &listed);
+    result.resize(entries.size());
+    std::vector<char> fetched(entries.size(), 0);
+
+    afc_client_pool* pool = (entries.size() >= min_parallel_stat_entries) ? get_client_pool() : nullptr;
+    if (pool)
+    {
+        std::atomic<size_t> next_entry(0);
+        std::vector<std::thread> workers;
+        size_t worker_count = std::min(pool->size(), entries.size());
+
+        for (size_t w = 0; w < worker_count; w++)
+        {
+            workers.push_back(std::thread([&]()
+            {
+                afc_client_pool::lease borrowed = pool->acquire();
+                if (!borrowed)
+                {
+                    return;
+                }
+
+                size_t i;
+                while ((i = next_entry++) < entries.size())
+                {
+                    std::string full_path = join_remote_path(path, entries[i]);
+                    char** file_info_list = nullptr;
+                    afc_error_t ret = afc_get_file_info(borrowed.get(), full_path.c_str(), &file_info_list);
+
+                    if (ret == AFC_E_SUCCESS && file_info_list)
+                    {
+                        result[i] = parse_file_info(full_path, file_info_list);
+                        fetched[i] = 1;
+                    }
+                    else if (ret != AFC_E_SUCCESS && ret != AFC_E_OBJECT_NOT_FOUND && ret != AFC_E_PERM_DENIED)
+                    {
+                        // Connection trouble; leave the rest to the other workers
+                        borrowed.mark_failed();
+                        break;
+                    }
+                }
+            }));
+        }
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+
+    // Anything the workers could not stat is retried on the primary connection
+    bool all_stated = true;
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        if (!fetched[i])
+        {
+            result[i] = get_file_info(join_remote_path(path, entries[i]));
+            all_stated = all_stated && result[i].file_type != afc_file_type::unknown;
+        }
+        else if (metadata_cache)
+        {
+            metadata_cache->store(result[i].full_path, true, result[i]);
+        }
+    }
+
+    if (complete)
+    {
+        *complete = listed && all_stated;
+    }
+
+    return result;
+}
+
+/*****************************************************************************/
+/* Function Name: walk_tree                                                  */
+/*                                                                           */
+/* Description: Walks a remote tree breadth-first over the pooled AFC        */
+/*              connections. Directory listings and batches of entry stats   */
+/*              are queued per worker; a worker that runs out of work steals */
+/*              from the others. The visitor sees every entry once and can   */
+/*              prune a directory or stop the walk. Visitor calls are        */
+/*              serialized, so it does not need to be thread safe, but it    */
+/*              must not start pooled operations while the walk holds the    */
+/*              pool. Returns false if the root could not be listed. Work    */
+/*              left undone for lack of a connection counts as errors        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Count abandoned work as errors      */
+/*****************************************************************************/
+bool afc_manager::walk_tree(const std::string& root, const walk_visitor& visitor, walk_stats* stats)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    // An item with no names lists its directory; otherwise it stats those names
+    struct walk_item {
+        std::string directory;
+        std::vector<std::string> names;
+        unsigned depth;
+    };
+
+    struct worker_queue {
+        std::mutex lock;
+        std::deque<walk_item> items;
+    };
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    afc_client_pool* pool = get_client_pool();
+    size_t worker_count = pool ? pool->size() : 1;
+
+    std::vector<worker_queue> queues(worker_count);
+    std::atomic<size_t> pending(1);
+    std::atomic<bool> stopped(false);
+    std::atomic<uint64_t> directories(0);
+    std::atomic<uint64_t> entries(0);
+    std::atomic<uint64_t> errors(0);
+    std::atomic<uint64_t> steals(0);
+    std::mutex visitor_lock;
+    std::mutex idle_lock;
+    std::condition_variable work_added;
+
+    walk_item root_item;
+    root_item.directory = root;
+    root_item.depth = 0;
+    queues[0].items.push_back(root_item);
+
+    auto push_item = [&](size_t owner, walk_item item)
+    {
+        pending++;
+        {
+            std::lock_guard<std::mutex> guard(queues[owner].lock);
+            queues[owner].items.push_back(std::move(item));
+        }
+        work_added.notify_one();
+    };
+
+    // Own queue is served oldest first to stay breadth-first; thieves take the newest
+    auto take_item = [&](size_t owner, walk_item& item)
+    {
+        {
+            std::lock_guard<std::mutex> guard(queues[owner].lock);
+            if (!queues[owner].items.empty())
+            {
+                item = std::move(queues[owner].items.front());
+                queues[owner].items.pop_front();
+                return true;
+            }
+        }
+
+        for (size_t offset = 1; offset < queues.size(); offset++)
+        {
+            worker_queue& victim = queues[(owner + offset) % queues.size()];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.items.empty())
+            {
+                item = std::move(victim.items.back());
+                victim.items.pop_back();
+                steals++;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto process_item = [&](size_t owner, afc_client_t client, walk_item& item)
+    {
+        if (item.names.empty())
+        {
+            char** list = nullptr;
+            afc_error_t ret = afc_read_directory(client, item.directory.c_str(), &list);
+            if (ret != AFC_E_SUCCESS)
+            {
+                // A directory that vanished or is off limits says nothing about the connection
+                std::cerr << "Error: Failed to read directory: " << item.directory << std::endl;
+                errors++;
+                return ret == AFC_E_OBJECT_NOT_FOUND || ret == AFC_E_PERM_DENIED;
+            }
+            directories++;
+
+            walk_item batch;
+            batch.directory = item.directory;
+            batch.depth = item.depth + 1;
+            for (int i = 0; list && list[i]; i++)
+            {
+                if (strcmp(list[i], ".") == 0 || strcmp(list[i], "..") == 0)
+                {
+                    continue;
+                }
+
+                batch.names.push_back(list[i]);
+                if (batch.names.size() == walk_batch_size)
+                {
+                    push_item(owner, batch);
+                    batch.names.clear();
+                }
+            }
+            if (!batch.names.empty())
+            {
+                push_item(owner, batch);
+            }
+            afc_dictionary_free(list);
+            return true;
+        }
+
+        bool connection_ok = true;
+        for (const auto& name : item.names)
+        {
+            if (stopped)
+            {
+                break;
+            }
+
+            std::string full_path = join_remote_path(item.directory, name);
+            char** file_info_list = nullptr;
+            afc_error_t ret = afc_get_file_info(client, full_path.c_str(), &file_info_list);
+            if (ret != AFC_E_SUCCESS || !file_info_list)
+            {
+                errors++;
+                if (ret != AFC_E_OBJECT_NOT_FOUND && ret != AFC_E_PERM_DENIED)
+                {
+                    connection_ok = false;
+                }
+                continue;
+            }
+
+            file_info info = parse_file_info(full_path, file_info_list);
+            if (metadata_cache)
+            {
+                metadata_cache->store(full_path, true, info);
+            }
+            entries++;
+
+            walk_action action;
+            {
+                std::lock_guard<std::mutex> guard(visitor_lock);
+                action = stopped ? walk_action::stop : visitor(info, item.depth);
+            }
+
+            if (action == walk_action::stop)
+            {
+                stopped = true;
+                work_added.notify_all();
+            }
+            else if (action == walk_action::descend && info.is_directory())
+            {
+                walk_item child;
+                child.directory = full_path;
+                child.depth = item.depth;
+                push_item(owner, child);
+            }
+        }
+        return connection_ok;
+    };
+
+    auto run_worker = [&](size_t owner, afc_client_pool::lease* borrowed)
+    {
+        afc_client_t client = borrowed ? borrowed->get() : afc_client;
+
+        while (!stopped)
+        {
+            walk_item item;
+            if (!take_item(owner, item))
+            {
+                if (pending == 0)
+                {
+                    break;
+                }
+
+                std::unique_lock<std::mutex> guard(idle_lock);
+                work_added.wait_for(guard, std::chrono::milliseconds(2));
+                continue;
+            }
+
+            if (!process_item(owner, client, item) && borrowed)
+            {
+                // Swap in a fresh connection for the rest of the walk. The old one has
+                // to go back first or a pool with no spare clients would never hand one out
+                borrowed->mark_failed();
+                borrowed->release();
+                *borrowed = pool->acquire();
+                if (!*borrowed)
+                {
+                    pending--;
+                    break;
+                }
+                client = borrowed->get();
+            }
+
+            if (--pending == 0)
+            {
+                work_added.notify_all();
+            }
+        }
+    };
+
+    if (pool)
+    {
+        std::vector<std::thread> workers;
+        for (size_t w = 0; w < worker_count; w++)
+        {
+            workers.push_back(std::thread([&, w]()
+            {
+                afc_client_pool::lease borrowed = pool->acquire();
+                if (borrowed)
+                {
+                    run_worker(w, &borrowed);
+                }
+            }));
+        }
+
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+    else
+    {
+        run_worker(0, nullptr);
+    }
+
+    // Workers that could not get a working connection leave their items undone
+    if (!stopped && pending > 0)
+    {
+        errors += pending;
+    }
+
+    if (stats)
+    {
+        stats->directories = directories;
+        stats->entries = entries;
+        stats->errors = errors;
+        stats->steals = steals;
+        stats->workers = static_cast<unsigned>(worker_count);
+        stats->elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    }
+
+    return directories > 0;
+}
+
+/*****************************************************************************/
+/* Function Name: create_directory                                           */
+/*                                                                           */
+/* Description: Creates a new directory on the device                        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Invalidate cached metadata          */
+/*****************************************************************************/
+bool afc_manager::create_directory(const std::string& path)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    afc_error_t ret = afc_make_directory(afc_client, path.c_str());
+    invalidate_cached_info(path, false);
+    if (ret != AFC_E_SUCCESS)
+    {
+        std::cerr << "Error: Failed to create directory: " << path << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: remove_path                                                */
+/*                                                                           */
+/* Description: Removes a file or directory from the device                  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Invalidate cached metadata          */
+/*****************************************************************************/
+bool afc_manager::remove_path(const std::string& path)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    afc_error_t ret = afc_remove_path(afc_client, path.c_str());
+    invalidate_cached_info(path, true);
+    if (ret != AFC_E_SUCCESS)
+    {
+        std::cerr << "Error: Failed to remove path: " << path << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: remove_tree                                                */
+/*                                                                           */
+/* Description: Removes a remote directory and everything below it. The      */
+/*              tree is walked once, then all files are deleted across the   */
+/*              pooled connections and the directories are removed one       */
+/*              depth level at a time, deepest first, so every directory is  */
+/*              already empty when its turn comes. A plain file is simply    */
+/*              removed                                                      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool afc_manager::remove_tree(const std::string& path)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    file_info root = get_file_info(path);
+    if (!root.is_directory())
+    {
+        return remove_path(path);
+    }
+
+    std::vector<std::string> files;
+    std::vector<std::vector<std::string> > levels;
+    bool listed = walk_tree(path,
+        [&](const file_info& entry, unsigned depth)
+        {
+            if (entry.is_directory())
+            {
+                if (levels.size() < depth)
+                {
+                    levels.resize(depth);
+                }
+                levels[depth - 1].push_back(entry.full_path);
+            }
+            else
+            {
+                files.push_back(entry.full_path);
+            }
+            return walk_action::descend;
+        });
+
+    if (!listed)
+    {
+        std::cerr << "Error: Failed to list remote directory: " << path << std::endl;
+        return false;
+    }
+
+    // Something already gone is as good as removed
+    auto remove_one = [](afc_client_t client, const std::string& target)
+    {
+        afc_error_t ret = afc_remove_path(client, target.c_str());
+        if (ret != AFC_E_SUCCESS && ret != AFC_E_OBJECT_NOT_FOUND)
+        {
+            std::cerr << "Error: Failed to remove path: " << target << std::endl;
+            return false;
+        }
+        return true;
+    };
+
+    bool success = run_on_pool(files.size(),
+        [&](afc_client_t client, size_t i)
+        {
+            return remove_one(client, files[i]);
+        });
+
+    size_t directory_count = 0;
+    for (size_t level = levels.size(); level > 0; level--)
+    {
+        const std::vector<std::string>& directories = levels[level - 1];
+        directory_count += directories.size();
+        success = run_on_pool(directories.size(),
+            [&](afc_client_t client, size_t i)
+            {
+                return remove_one(client, directories[i]);
+            }) && success;
+    }
+
+    success = remove_one(afc_client, path) && success;
+    invalidate_cached_info(path, true);
+
+    std::cout << "Removed " << files.size() << " files and " << directory_count + 1
+              << " directories under " << path << std::endl;
+
+    return success;
+}
+
+/*****************************************************************************/
+/* Function Name: move_path                                                  */
+/*                                                                           */
+/* Description: Moves or renames a file or directory on the device. AFC      */
+/*              does this in a single request, so nothing is transferred     */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool afc_manager::move_path(const std::string& source_path, const std::string& destination_path)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    afc_error_t ret = afc_rename_path(afc_client, source_path.c_str(), destination_path.c_str());
+    invalidate_cached_info(source_path, true);
+    invalidate_cached_info(destination_path, true);
+    if (ret != AFC_E_SUCCESS)
+    {
+        std::cerr << "Error: Failed to move " << source_path << " to " << destination_path << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: copy_tree                                                  */
+/*                                                                           */
+/* Description: Copies a remote file or directory tree to another location   */
+/*              on the device. AFC has no copy request, so file contents     */
+/*              pass through host memory, but never touch the local disk.    */
+/*              Directories are created parents first, one depth level at a  */
+/*              time, then the files are copied across the pooled            */
+/*              connections. Copying onto the source itself or into it is    */
+/*              refused before anything is opened, since opening the         */
+/*              destination for writing would truncate the source            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Refuse overlapping paths            */
+/*****************************************************************************/
+bool afc_manager::copy_tree(const std::string& source_path, const std::string& destination_path)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    std::string source = normalize_remote_path(source_path);
+    std::string destination = normalize_remote_path(destination_path);
+    if (source == destination)
+    {
+        std::cerr << "Error: Cannot copy a path onto itself: " << destination_path << std::endl;
+        return false;
+    }
+
+    std::string source_prefix = join_remote_path(source, "");
+    if (destination.compare(0, source_prefix.size(), source_prefix) == 0)
+    {
+        std::cerr << "Error: Cannot copy a directory into itself: " << destination_path << std::endl;
+        return false;
+    }
+
+    file_info root = get_file_info(source_path);
+    if (!root.is_directory())
+    {
+        bool copied = copy_on_client(afc_client, source_path, destination_path);
+        invalidate_cached_info(destination_path, false);
+        return copied;
+    }
+
+    size_t prefix_length = source_path.find_last_not_of('/');
+    prefix_length = (prefix_length == std::string::npos) ? 1 : prefix_length + 2;
+
+    std::vector<transfer_request> files;
+    std::vector<std::vector<std::string> > levels;
+    bool listed = walk_tree(source_path,
+        [&](const file_info& entry, unsigned depth)
+        {
+            std::string target = join_remote_path(destination_path, entry.full_path.substr(prefix_length));
+            if (entry.is_directory())
+            {
+                if (levels.size() < depth)
+                {
+                    levels.resize(depth);
+                }
+                levels[depth - 1].push_back(target);
+            }
+            else
+            {
+                transfer_request request;
+                request.source_path = entry.full_path;
+                request.destination_path = target;
+                files.push_back(request);
+            }
+            return walk_action::descend;
+        });
+
+    if (!listed)
+    {
+        std::cerr << "Error: Failed to list remote directory: " << source_path << std::endl;
+        return false;
+    }
+
+    auto make_one = [](afc_client_t client, const std::string& target)
+    {
+        if (afc_make_directory(client, target.c_str()) != AFC_E_SUCCESS)
+        {
+            std::cerr << "Error: Failed to create directory: " << target << std::endl;
+            return false;
+        }
+        return true;
+    };
+
+    bool success = make_one(afc_client, destination_path);
+    for (size_t level = 0; level < levels.size() && success; level++)
+    {
+        const std::vector<std::string>& directories = levels[level];
+        success = run_on_pool(directories.size(),
+            [&](afc_client_t client, size_t i)
+            {
+                return make_one(client, directories[i]);
+            });
+    }
+
+    if (success)
+    {
+        success = run_on_pool(files.size(),
+            [&](afc_client_t client, size_t i)
+            {
+                return copy_on_client(client, files[i].source_path, files[i].destination_path);
+            });
+    }
+
+    invalidate_cached_info(destination_path, true);
+
+    if (success)
+    {
+        std::cout << "Copied " << files.size() << " files from " << source_path << " to "
+                  << destination_path << std::endl;
+    }
+
+    return success;
+}
+
+/*****************************************************************************/
+/* Function Name: copy_on_client                                             */
+/*                                                                           */
+/* Description: Copies one remote file to another remote path over the       */
+/*              given AFC connection, chunk by chunk through a host buffer   */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Grow buffer with the file           */
+/* 2026-10-16      S. Amalfitano         Refuse copying a file onto itself   */
+/*****************************************************************************/
+bool afc_manager::copy_on_client(afc_client_t client, const std::string& source_path,
+                                 const std::string& destination_path)
+{
+    if (normalize_remote_path(source_path) == normalize_remote_path(destination_path))
+    {
+        std::cerr << "Error: Cannot copy a path onto itself: " << destination_path << std::endl;
+        return false;
+    }
+
+    uint64_t source = 0;
+    if (afc_file_open(client, source_path.c_str(), AFC_FOPEN_RDONLY, &source) != AFC_E_SUCCESS)
+    {
+        std::cerr << "Error: Failed to open remote file: " << source_path << std::endl;
+        return false;
+    }
+
+    uint64_t destination = 0;
+    if (afc_file_open(client, destination_path.c_str(), AFC_FOPEN_WR, &destination) != AFC_E_SUCCESS)
+    {
+        std::cerr << "Error: Failed to create remote file: " << destination_path << std::endl;
+        afc_file_close(client, source);
+        return false;
+    }
+
+    // The buffer grows with the file instead of starting at the maximum chunk size
+    chunk_sizer read_sizer(initial_chunk_size, max_chunk_size);
+    chunk_sizer write_sizer(initial_chunk_size, max_chunk_size);
+    std::vector<char> buffer(std::min(initial_buffer_size, read_sizer.maximum()));
+    uint64_t position = 0;
+    bool success = true;
+
+    while (true)
+    {
+        uint32_t bytes_read = 0;
+        uint32_t limit = static_cast<uint32_t>(buffer.size());
+        if (!read_chunk(client, source, position, buffer.data(), limit, read_sizer, &bytes_read))
+        {
+            std::cerr << "Error: Failed to read from remote file: " << source_path << std::endl;
+            success = false;
+            break;
+        }
+
+        if (bytes_read == 0)
+        {
+            break;
+        }
+
+        if (!write_chunk(client, destination, position, buffer.data(), bytes_read, write_sizer))
+        {
+            std::cerr << "Error: Failed to write to remote file: " << destination_path << std::endl;
+            success = false;
+            break;
+        }
+
+        position += bytes_read;
+        if (bytes_read == limit && limit < read_sizer.maximum())
+        {
+            buffer.resize(std::min(limit * 2, read_sizer.maximum()));
+        }
+    }
+
+    afc_file_close(client, destination);
+    afc_file_close(client, source);
+
+    return success;
+}
+
+/*****************************************************************************/
+/* Function Name: download_file                                              */
+/*                                                                           */
+/* Description: Downloads a file from the device to local filesystem         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Adaptive chunk sizing               */
+/* 2026-10-16      S. Amalfitano         Overlap reads and disk writes       */
+/* 2026-10-16      S. Amalfitano         Resume from partial-file journal    */
+/* 2026-10-16      S. Amalfitano         Moved body to download_on_client    */
+/*****************************************************************************/
+bool afc_manager::download_file(const std::string& source_path, const std::string& destination_path,
+                                transfer_stats* stats)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    return download_on_client(afc_client, source_path, destination_path, stats);
+}
+
+/*****************************************************************************/
+/* Function Name: download_on_client                                         */
+/*                                                                           */
+/* Description: Downloads a file over the given AFC connection, resuming     */
+/*              from a matching journal when enabled. Shared by the          */
+/*              sequential and the pooled batch download paths. The XXH3     */
+/*              digest of the file is computed as chunks are written, so     */
+/*              verifying it needs no second pass over the local copy        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Hash contents while writing         */
+/* 2026-10-16      S. Amalfitano         Write through download_sink         */
+/* 2026-10-16      S. Amalfitano         Ignore journals of split downloads  */
+/*****************************************************************************/
+bool afc_manager::download_on_client(afc_client_t client, const std::string& source_path,
+                                     const std::string& destination_path, transfer_stats* stats)
+{
+    // Continue a previous attempt if its journal still matches the remote file
+    std::string journal_path = destination_path + journal_suffix;
+    download_journal journal;
+    uint64_t start_offset = 0;
+
+    if (resume_downloads)
+    {
+        file_info info = query_file_info(client, source_path);
+        download_journal previous;
+
+        if (load_journal(journal_path, previous) &&
+            previous.ranges.empty() &&
+            previous.remote_path == source_path &&
+            previous.remote_size == info.file_size &&
+            previous.remote_mtime == info.modified_time &&
+            previous.committed <= info.file_size &&
+            local_fs::stat_path(destination_path).file_size >= previous.committed)
+        {
+            start_offset = previous.committed;
+            std::cout << "Resuming " << source_path << " at " << format_file_size(start_offset) << std::endl;
+        }
+
+        journal.remote_path = source_path;
+        journal.remote_size = info.file_size;
+        journal.remote_mtime = info.modified_time;
+        journal.committed = start_offset;
+    }
+
+    download_sink output(destination_path, resume_downloads ? &journal : nullptr);
+    bool success = stream_on_client(client, source_path, output, start_offset, stats);
+
+    if (stats)
+    {
+        stats->resumed_from = start_offset;
+        stats->content_hash = success ? output.digest() : std::string();
+    }
+
+    return success;
+}
+
+/*****************************************************************************/
+/* Function Name: read_stream                                                */
+/*                                                                           */
+/* Description: Streams a remote file, from offset to its end, into a sink.  */
+/*              Chunks are handed over straight from the read pipeline       */
+/*              buffers without copying, while the next reads are already in */
+/*              flight. A sink that blocks in consume stalls the device      */
+/*              reads once every pipeline buffer is full                     */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool afc_manager::read_stream(const std::string& path, afc_read_sink& sink, uint64_t offset, transfer_stats* stats)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    return stream_on_client(afc_client, path, sink, offset, stats);
+}
+
+/*****************************************************************************/
+/* Function Name: stream_on_client                                           */
+/*                                                                           */
+/* Description: Opens a remote file on the given AFC connection and feeds    */
+/*              it through the read pipeline into a sink. The sink is only   */
+/*              started once the remote file is open                         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool afc_manager::stream_on_client(afc_client_t client, const std::string& path, afc_read_sink& sink,
+                                   uint64_t offset, transfer_stats* stats)
+{
+    uint64_t handle = 0;
+    if (afc_file_open(client, path.c_str(), AFC_FOPEN_RDONLY, &handle) != AFC_E_SUCCESS)
+    {
+        std::cerr << "Error: Failed to open remote file: " << path << std::endl;
+        return false;
+    }
+
+    if (!sink.begin(path, offset))
+    {
+        afc_file_close(client, handle);
+        return false;
+    }
+
+    bool success = pipelined_read(client, handle, offset,
+        [&](const char* data, uint32_t length)
+        {
+            return sink.consume(data, length);
+        },
+        stats);
+
+    afc_file_close(client, handle);
+    return sink.finish(success);
+}
+
+/*****************************************************************************/
+/* Function Name: pipelined_read                                             */
+/*                                                                           */
+/* Description: Streams an open remote file from start_offset to its end.    */
+/*              A reader thread issues adaptively sized AFC reads into a     */
+/*              bounded set of reusable buffers while the calling thread     */
+/*              passes each filled buffer to write_stage, so device latency  */
+/*              and local write latency overlap                              */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Grow buffers with the file          */
+/*****************************************************************************/
+bool afc_manager::pipelined_read(afc_client_t client, uint64_t handle, uint64_t start_offset,
+                                 const std::function<bool(const char*, uint32_t)>& write_stage,
+                                 transfer_stats* stats)
+{
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    if (start_offset > 0 &&
+        afc_file_seek(client, handle, static_cast<int64_t>(start_offset), SEEK_SET) != AFC_E_SUCCESS)
+    {
+        std::cerr << "Error: Failed to seek remote file to offset " << start_offset << std::endl;
+        return false;
+    }
+
+    // Buffers grow only while reads keep filling them, so a small file does
+    // not pay for allocating and clearing several maximum-size buffers
+    chunk_sizer sizer(initial_chunk_size, max_chunk_size);
+    uint32_t buffer_size = std::min(initial_buffer_size, sizer.maximum());
+    chunk_pipeline pipeline(pipeline_buffer_count, buffer_size);
+    bool read_failed = false;
+    double read_seconds = 0.0;
+
+    std::thread reader([&]()
+    {
+        uint64_t position = start_offset;
+
+        while (true)
+        {
+            pipeline_buffer* buffer = pipeline.acquire();
+            if (!buffer)
+            {
+                break;  // Writer gave up
+            }
+
+            if (buffer->data.size() < buffer_size)
+            {
+                buffer->data.resize(buffer_size);
+            }
+
+            uint32_t bytes_read = 0;
+            uint32_t limit = static_cast<uint32_t>(buffer->data.size());
+            std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+            bool ok = read_chunk(client, handle, position, buffer->data.data(), limit, sizer, &bytes_read);
+            read_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+            if (!ok)
+            {
+                // Let the writer drain what was already read so it can be committed
+                std::cerr << "Error: Failed to read from remote file." << std::endl;
+                read_failed = true;
+                pipeline.release(buffer);
+                break;
+            }
+
+            if (bytes_read == 0)
+            {
+                pipeline.release(buffer);
+                break;  // End of file
+            }
+
+            if (bytes_read == limit && buffer_size < sizer.maximum())
+            {
+                buffer_size = std::min(buffer_size * 2, sizer.maximum());
+            }
+
+            buffer->length = bytes_read;
+            buffer->offset = position;
+            position += bytes_read;
+            pipeline.submit(buffer);
+        }
+
+        pipeline.finish();
+    });
+
+    bool write_failed = false;
+    double write_seconds = 0.0;
+    uint64_t bytes_written = 0;
+
+    while (pipeline_buffer* buffer = pipeline.next())
+    {
+        std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+        bool ok = write_stage(buffer->data.data(), buffer->length);
+        write_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        if (!ok)
+        {
+            write_failed = true;
+            pipeline.release(buffer);
+            pipeline.cancel();
+            break;
+        }
+
+        bytes_written += buffer->length;
+        pipeline.release(buffer);
+    }
+
+    reader.join();
+
+    if (stats)
+    {
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        stats->bytes_transferred = bytes_written;
+        stats->elapsed_seconds = elapsed;
+        stats->throughput_mbps = (elapsed > 0.0) ? (bytes_written / 1048576.0) / elapsed : 0.0;
+        stats->connections_used = 1;
+        stats->read_seconds = read_seconds;
+        stats->write_seconds = write_seconds;
+        stats->read_stall_seconds = pipeline.producer_wait();
+        stats->write_stall_seconds = pipeline.consumer_wait();
+    }
+
+    return !read_failed && !write_failed;
+}
+
+/*****************************************************************************/
+/* Function Name: read_range                                                 */
+/*                                                                           */
+/* Description: Reads length bytes starting at offset from a remote file     */
+/*              into data, without transferring the rest of the file. data   */
+/*              is shorter than length when the file ends first              */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool afc_manager::read_range(const std::string& path, uint64_t offset, uint32_t length, std::vector<char>& data)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    return read_range_on_client(afc_client, path, offset, length, data);
+}
+
+/*****************************************************************************/
+/* Function Name: read_ranges                                                */
+/*                                                                           */
+/* Description: Performs a batch of range reads across the pooled            */
+/*              connections, filling in data and completed on each entry.    */
+/*              Returns true only if every range was read                    */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool afc_manager::read_ranges(std::vector<range_read>& reads)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    return run_on_pool(reads.size(),
+        [&](afc_client_t client, size_t i)
+        {
+            range_read& item = reads[i];
+            item.completed = read_range_on_client(client, item.path, item.offset, item.length, item.data);
+            return item.completed;
+        });
+}
+
+/*****************************************************************************/
+/* Function Name: read_range_on_client                                       */
+/*                                                                           */
+/* Description: Opens a remote file on the given AFC connection, seeks to    */
+/*              offset and reads up to length bytes. A range up to the       */
+/*              maximum chunk size is fetched with a single read request     */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool afc_manager::read_range_on_client(afc_client_t client, const std::string& path, uint64_t offset,
+                                       uint32_t length, std::vector<char>& data)
+{
+    data.clear();
+
+    uint64_t handle = 0;
+    if (afc_file_open(client, path.c_str(), AFC_FOPEN_RDONLY, &handle) != AFC_E_SUCCESS)
+    {
+        std::cerr << "Error: Failed to open remote file: " << path << std::endl;
+        return false;
+    }
+
+    if (offset > 0 && afc_file_seek(client, handle, static_cast<int64_t>(offset), SEEK_SET) != AFC_E_SUCCESS)
+    {
+        std::cerr << "Error: Failed to seek remote file to offset " << offset << std::endl;
+        afc_file_close(client, handle);
+        return false;
+    }
+
+    chunk_sizer sizer(length, max_chunk_size);
+    data.resize(length);
+    uint32_t filled = 0;
+    bool success = true;
+
+    while (filled < length)
+    {
+        uint32_t bytes_read = 0;
+        if (!read_chunk(client, handle, offset + filled, data.data() + filled, length - filled, sizer, &bytes_read))
+        {
+            std::cerr << "Error: Failed to read from remote file: " << path << std::endl;
+            success = false;
+            break;
+        }
+
+        if (bytes_read == 0)
+        {
+            break;  // End of file
+        }
+        filled += bytes_read;
+    }
+
+    afc_file_close(client, handle);
+    data.resize(filled);
+
+    return success;
+}
+
+/*****************************************************************************/
+/* Function Name: download_file_parallel                                     */
+/*                                                                           */
+/* Description: Downloads a single large file over several AFC connections.  */
+/*              The file is split into contiguous byte ranges, each range    */
+/*              is fetched on its own connection and written at its offset   */
+/*              in the destination file. Small files, and files that find    */
+/*              fewer than two pooled connections free, fall back to         */
+/*              download_file. Ranges finish out of order, so no content     */
+/*              hash is computed when the file is actually split. With       */
+/*              resume enabled the journal records how far each range got,   */
+/*              and a later attempt continues every range from there         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Journal and resume each range       */
+/* 2026-10-16      S. Amalfitano         Never wait for a pooled connection  */
+/*****************************************************************************/
+bool afc_manager::download_file_parallel(const std::string& source_path, const std::string& destination_path,
+                                         transfer_stats* stats)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    file_info info = get_file_info(source_path);
+    if (info.is_directory())
+    {
+        std::cerr << "Error: Cannot download a directory: " << source_path << std::endl;
+        return false;
+    }
+
+    uint64_t file_size = info.file_size;
+    uint64_t wanted = std::max<uint64_t>(1, file_size / min_parallel_range_size);
+    unsigned connection_count = static_cast<unsigned>(std::min<uint64_t>(parallel_connections, wanted));
+
+    // Borrow whatever pooled connections are free, without waiting on other users
+    std::vector<afc_client_pool::lease> leases;
+    afc_client_pool* pool = (connection_count > 1) ? get_client_pool() : nullptr;
+    while (pool && leases.size() < connection_count)
+    {
+        afc_client_pool::lease borrowed = pool->try_acquire();
+        if (!borrowed)
+        {
+            break;
+        }
+        leases.push_back(std::move(borrowed));
+    }
+
+    if (leases.size() < 2)
+    {
+        leases.clear();
+        return download_file(source_path, destination_path, stats);
+    }
+
+    // Continue the ranges of an earlier split attempt if its journal still matches
+    std::string journal_path = destination_path + journal_suffix;
+    download_journal journal;
+    journal.remote_path = source_path;
+    journal.remote_size = file_size;
+    journal.remote_mtime = info.modified_time;
+    journal.committed = 0;
+
+    download_journal previous;
+    if (resume_downloads && load_journal(journal_path, previous) &&
+        !previous.ranges.empty() &&
+        previous.remote_path == source_path &&
+        previous.remote_size == file_size &&
+        previous.remote_mtime == info.modified_time &&
+        local_fs::stat_path(destination_path).file_size == file_size)
+    {
+        bool valid = true;
+        for (const auto& range : previous.ranges)
+        {
+            valid = valid && range.first <= range.second && range.second <= file_size;
+        }
+        if (valid)
+        {
+            journal.ranges = previous.ranges;
+        }
+    }
+
+    uint64_t resumed_bytes = 0;
+    if (!journal.ranges.empty())
+    {
+        uint64_t remaining = 0;
+        for (const auto& range : journal.ranges)
+        {
+            remaining += range.second - range.first;
+        }
+        resumed_bytes = file_size - remaining;
+        std::cout << "Resuming " << source_path << " with " << format_file_size(remaining) << " left" << std::endl;
+    }
+    else
+    {
+        // An old journal describes other contents; drop it before the file is truncated
+        std::remove(journal_path.c_str());
+
+        // Create the destination at its final size so every range can be written in place
+        std::ofstream outfile(destination_path, std::ios::binary | std::ios::trunc);
+        if (!outfile.is_open())
+        {
+            std::cerr << "Error: Failed to create local file: " << destination_path << std::endl;
+            return false;
+        }
+        outfile.seekp(static_cast<std::streamoff>(file_size - 1));
+        outfile.put('\0');
+        if (!outfile.good())
+        {
+            std::cerr << "Error: Failed to allocate local file: " << destination_path << std::endl;
+            return false;
+        }
+
+        uint64_t range_size = file_size / leases.size();
+        for (size_t i = 0; i < leases.size(); i++)
+        {
+            uint64_t range_start = range_size * i;
+            uint64_t range_end = (i == leases.size() - 1) ? file_size : range_start + range_size;
+            journal.ranges.push_back(std::make_pair(range_start, range_end));
+        }
+    }
+
+    std::mutex journal_lock;
+    if (resume_downloads && !save_journal(journal_path, journal))
+    {
+        std::cerr << "Warning: Failed to write resume journal: " << journal_path << std::endl;
+    }
+
+    // Records how far a range has reached on disk; the caller has flushed its writes
+    auto commit_range = [&](size_t range, uint64_t position)
+    {
+        std::lock_guard<std::mutex> guard(journal_lock);
+        journal.ranges[range].first = position;
+        if (resume_downloads)
+        {
+            save_journal(journal_path, journal);
+        }
+    };
+
+    std::atomic<bool> failed(false);
+    std::atomic<uint64_t> total_bytes(0);
+    std::atomic<size_t> next_range(0);
+    std::vector<std::thread> workers;
+
+    for (size_t i = 0; i < leases.size(); i++)
+    {
+        afc_client_pool::lease* borrowed = &leases[i];
+
+        workers.push_back(std::thread([&, borrowed]()
+        {
+            afc_client_t client = borrowed->get();
+            uint64_t handle = 0;
+            if (afc_file_open(client, source_path.c_str(), AFC_FOPEN_RDONLY, &handle) != AFC_E_SUCCESS)
+            {
+                std::cerr << "Error: Failed to open remote file: " << source_path << std::endl;
+                borrowed->mark_failed();
+                failed = true;
+                return;
+            }
+
+            std::fstream outfile(destination_path, std::ios::in | std::ios::out | std::ios::binary);
+            if (!outfile.is_open())
+            {
+                std::cerr << "Error: Failed to open local file: " << destination_path << std::endl;
+                afc_file_close(client, handle);
+                failed = true;
+                return;
+            }
+
+            chunk_sizer sizer(initial_chunk_size, max_chunk_size);
+            std::vector<char> buffer(sizer.maximum());
+
+            for (size_t range = next_range++; range < journal.ranges.size() && !failed; range = next_range++)
+            {
+                uint64_t position = journal.ranges[range].first;
+                uint64_t range_end = journal.ranges[range].second;
+                if (position >= range_end)
+                {
+                    continue;
+                }
+
+                if (afc_file_seek(client, handle, static_cast<int64_t>(position), SEEK_SET) != AFC_E_SUCCESS)
+                {
+                    std::cerr << "Error: Failed to position range at offset " << position << std::endl;
+                    borrowed->mark_failed();
+                    failed = true;
+                    break;
+                }
+                outfile.seekp(static_cast<std::streamoff>(position));
+
+                uint64_t committed = position;
+                while (position < range_end && !failed)
+                {
+                    uint32_t limit = static_cast<uint32_t>(std::min<uint64_t>(sizer.maximum(), range_end - position));
+                    uint32_t bytes_read = 0;
+
+                    if (!read_chunk(client, handle, position, buffer.data(), limit, sizer, &bytes_read) || bytes_read == 0)
+                    {
+                        std::cerr << "Error: Failed to read range at offset " << position << std::endl;
+                        borrowed->mark_failed();
+                        failed = true;
+                        break;
+                    }
+
+                    outfile.write(buffer.data(), bytes_read);
+                    if (!outfile.good())
+                    {
+                        std::cerr << "Error: Failed to write to local file." << std::endl;
+                        failed = true;
+                        break;
+                    }
+
+                    position += bytes_read;
+                    total_bytes += bytes_read;
+
+                    if (position - committed >= journal_commit_interval && outfile.flush())
+                    {
+                        commit_range(range, position);
+                        committed = position;
+                    }
+                }
+
+                // Whatever was written is kept for the next attempt
+                if (outfile.flush())
+                {
+                    commit_range(range, position);
+                }
+            }
+
+            afc_file_close(client, handle);
+        }));
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    size_t connections_used = leases.size();
+    leases.clear();
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    double throughput = (elapsed > 0.0) ? (total_bytes / 1048576.0) / elapsed : 0.0;
+
+    if (stats)
+    {
+        stats->bytes_transferred = total_bytes;
+        stats->elapsed_seconds = elapsed;
+        stats->throughput_mbps = throughput;
+        stats->connections_used = static_cast<unsigned>(connections_used);
+        stats->resumed_from = resumed_bytes;
+    }
+
+    if (failed)
+    {
+        return false;
+    }
+
+    std::remove(journal_path.c_str());
+
+    char rate[32];
+    snprintf(rate, sizeof(rate), "%.2f", throughput);
+    std::cout << "Downloaded " << format_file_size(total_bytes) << " in " << elapsed << " s ("
+              << rate << " MB/s over " << connections_used << " connections)" << std::endl;
+
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: download_files                                             */
+/*                                                                           */
+/* Description: Downloads a batch of files. Each pooled connection runs a    */
+/*              worker that takes the next request from a shared counter, so */
+/*              many small files keep every connection busy instead of       */
+/*              paying one round trip after another on a single client.      */
+/*              results, if given, receives one entry per request. Returns   */
+/*              true only if every file was downloaded                       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Fan out through run_on_pool         */
+/*****************************************************************************/
+bool afc_manager::download_files(const std::vector<transfer_request>& requests,
+                                 std::vector<transfer_stats>* results)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    std::vector<transfer_stats> local_results(requests.size());
+    std::vector<transfer_stats>& item_stats = results ? *results : local_results;
+    item_stats.assign(requests.size(), transfer_stats());
+
+    return run_on_pool(requests.size(),
+        [&](afc_client_t client, size_t i)
+        {
+            item_stats[i].completed = download_on_client(client, requests[i].source_path,
+                                                         requests[i].destination_path, &item_stats[i]);
+            return item_stats[i].completed;
+        });
+}
+
+/*****************************************************************************/
+/* Function Name: run_on_pool                                                */
+/*                                                                           */
+/* Description: Runs task_count independent tasks over the pooled AFC        */
+/*              connections. One worker per connection takes the next task   */
+/*              index from a shared counter. A failed task has its           */
+/*              connection health-checked before the worker continues. With  */
+/*              a single connection the tasks run in order on the primary    */
+/*              client. Returns true only if every task succeeded            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool afc_manager::run_on_pool(size_t task_count, const std::function<bool(afc_client_t, size_t)>& task)
+{
+    unsigned worker_count = static_cast<unsigned>(std::min<size_t>(parallel_connections, task_count));
+    afc_client_pool* pool = (worker_count > 1) ? get_client_pool() : nullptr;
+
+    if (!pool)
+    {
+        bool all_ok = true;
+        for (size_t i = 0; i < task_count; i++)
+        {
+            all_ok = task(afc_client, i) && all_ok;
+        }
+        return all_ok;
+    }
+
+    std::atomic<size_t> next_task(0);
+    std::atomic<bool> all_ok(true);
+    std::vector<std::thread> workers;
+
+    for (unsigned w = 0; w < worker_count; w++)
+    {
+        workers.push_back(std::thread([&]()
+        {
+            afc_client_pool::lease borrowed = pool->acquire();
+
+            for (size_t i = next_task++; i < task_count; i = next_task++)
+            {
+                if (!borrowed)
+                {
+                    borrowed = pool->acquire();
+                }
+                if (!borrowed)
+                {
+                    all_ok = false;
+                    continue;
+                }
+
+                if (!task(borrowed.get(), i))
+                {
+                    // Have the pool check the connection before it is used again
+                    all_ok = false;
+                    borrowed.mark_failed();
+                    borrowed.release();
+                }
+            }
+        }));
+    }
+
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    return all_ok;
+}
+
+/*****************************************************************************/
+/* Function Name: mirror_directory                                           */
+/*                                                                           */
+/* Description: Makes local_root an up to date copy of remote_root. The      */
+/*              remote tree is walked for size and mtime only; files whose   */
+/*              metadata matches the manifest from the previous run, and     */
+/*              whose local copy is still present at that size, are          */
+/*              skipped. Everything else is downloaded over the client pool  */
+/*              and recorded in a new manifest. With prune_deleted, files    */
+/*              the manifest tracked that no longer exist on the device are  */
+/*              removed locally; untracked local files are never touched.    */
+/*              If any part of the tree could not be listed, nothing is      */
+/*              pruned, since a missing file may only be an unlisted one     */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         No pruning after listing errors     */
+/*****************************************************************************/
+bool afc_manager::mirror_directory(const std::string& remote_root, const std::string& local_root,
+                                   const mirror_options& options, mirror_stats* stats)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    if (!local_fs::make_directories(local_root))
+    {
+        std::cerr << "Error: Failed to create local directory: " << local_root << std::endl;
+        return false;
+    }
+
+    std::string manifest_path = local_fs::join_path(local_root, mirror_manifest_name);
+    mirror_manifest previous = load_manifest(manifest_path);
+    mirror_manifest current;
+
+    // Collect the remote tree first; the walk holds the pool while it runs
+    size_t prefix_length = remote_root.find_last_not_of('/');
+    prefix_length = (prefix_length == std::string::npos) ? 1 : prefix_length + 2;
+
+    std::vector<std::string> directories;
+    std::vector<file_info> files;
+    walk_stats walk;
+    bool listed = walk_tree(remote_root,
+        [&](const file_info& entry, unsigned)
+        {
+            if (entry.is_directory())
+            {
+                directories.push_back(entry.full_path.substr(prefix_length));
+            }
+            else
+            {
+                files.push_back(entry);
+            }
+            return walk_action::descend;
+        },
+        &walk);
+
+    if (!listed)
+    {
+        std::cerr << "Error: Failed to list remote directory: " << remote_root << std::endl;
+        return false;
+    }
+
+    mirror_stats totals;
+    totals.listing_errors = walk.errors;
+    if (walk.errors > 0 && options.prune_deleted)
+    {
+        std::cerr << "Error: Part of " << remote_root << " could not be listed (" << walk.errors
+                  << " errors); skipping pruning." << std::endl;
+    }
+
+    for (const auto& directory : directories)
+    {
+        std::string local_directory = local_fs::join_path(local_root, directory);
+        if (!local_fs::make_directories(local_directory))
+        {
+            std::cerr << "Error: Failed to create local directory: " << local_directory << std::endl;
+        }
+    }
+
+    std::vector<transfer_request> requests;
+    std::vector<std::string> request_paths;
+
+    for (const auto& file : files)
+    {
+        std::string relative_path = file.full_path.substr(prefix_length);
+        std::string local_path = local_fs::join_path(local_root, relative_path);
+        mirror_entry entry;
+        entry.remote_size = file.file_size;
+        entry.remote_mtime = file.modified_time;
+        totals.files_checked++;
+
+        mirror_manifest::const_iterator known = previous.find(relative_path);
+        if (known != previous.end() &&
+            known->second.remote_size == entry.remote_size &&
+            known->second.remote_mtime == entry.remote_mtime)
+        {
+            local_file_info local = local_fs::stat_path(local_path);
+            if (local.exists && !local.is_directory && local.file_size == entry.remote_size)
+            {
+                current[relative_path] = entry;
+                totals.files_unchanged++;
+                continue;
+            }
+        }
+
+        transfer_request request;
+        request.source_path = file.full_path;
+        request.destination_path = local_path;
+        requests.push_back(request);
+        request_paths.push_back(relative_path);
+        current[relative_path] = entry;
+    }
+
+    std::vector<transfer_stats> results;
+    if (!requests.empty())
+    {
+        download_files(requests, &results);
+    }
+
+    // Files that vanished from the device are either pruned or kept tracked
+    for (const auto& item : previous)
+    {
+        if (current.count(item.first) != 0)
+        {
+            continue;
+        }
+
+        if (!options.prune_deleted || totals.listing_errors > 0)
+        {
+            current.insert(item);
+        }
+        else if (local_fs::remove_file(local_fs::join_path(local_root, item.first)))
+        {
+            totals.files_pruned++;
+        }
+    }
+
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        if (i < results.size() && results[i].completed)
+        {
+            totals.files_transferred++;
+            totals.bytes_transferred += results[i].bytes_transferred;
+        }
+        else
+        {
+            // Leave it out of the manifest so the next run tries again
+            current.erase(request_paths[i]);
+            totals.files_failed++;
+        }
+    }
+
+    bool saved = save_manifest(manifest_path, current);
+    if (!saved)
+    {
+        std::cerr << "Error: Failed to write mirror manifest: " << manifest_path << std::endl;
+    }
+
+    totals.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    if (stats)
+    {
+        *stats = totals;
+    }
+
+    std::cout << "Mirrored " << remote_root << ": " << totals.files_transferred << " downloaded ("
+              << format_file_size(totals.bytes_transferred) << "), " << totals.files_unchanged << " unchanged, "
+              << totals.files_pruned << " pruned, " << totals.files_failed << " failed" << std::endl;
+
+    return saved && totals.files_failed == 0 && totals.listing_errors == 0;
+}
+
+/*****************************************************************************/
+/* Function Name: export_tar                                                 */
+/*                                                                           */
+/* Description: Streams a remote tree into a tar archive on output_fd, zstd  */
+/*              compressed if requested, in a single pass and without        */
+/*              staging files on disk. Entries are sorted by path and named  */
+/*              relative to the parent of remote_root. Each file is read     */
+/*              through the read pipeline while the archive writer (and its  */
+/*              compression threads) consume the previous chunks. A file     */
+/*              that changed size since the walk counts as failed            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Name the files that fail            */
+/*****************************************************************************/
+bool afc_manager::export_tar(const std::string& remote_root, int output_fd, const archive_options& options,
+                             transfer_stats* stats)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    file_info root = get_file_info(remote_root);
+    if (!root.is_directory())
+    {
+        std::cerr << "Error: Not a remote directory: " << remote_root << std::endl;
+        return false;
+    }
+
+    std::vector<file_info> entries;
+    bool listed = walk_tree(remote_root,
+        [&](const file_info& entry, unsigned)
+        {
+            if (entry.is_directory() || entry.file_type == afc_file_type::regular)
+            {
+                entries.push_back(entry);
+            }
+            return walk_action::descend;
+        });
+
+    if (!listed)
+    {
+        std::cerr << "Error: Failed to list remote directory: " << remote_root << std::endl;
+        return false;
+    }
+
+    std::sort(entries.begin(), entries.end(),
+        [](const file_info& a, const file_info& b)
+        {
+            return a.full_path < b.full_path;
+        });
+
+    // Members are named from the root directory down, e.g. DCIM/100APPLE/IMG_0001.JPG
+    size_t name_start = remote_root.find_last_not_of('/');
+    name_start = (name_start == std::string::npos) ? 1 : remote_root.rfind('/', name_start) + 1;
+
+    tar_writer archive(output_fd, options.compression_level, options.compression_threads);
+    if (root.full_path.size() > name_start)
+    {
+        archive.add_directory(root.full_path.substr(name_start), root.modified_time / 1000000000ULL);
+    }
+
+    uint64_t total_bytes = 0;
+    size_t file_count = 0;
+    size_t failures = 0;
+
+    for (const auto& entry : entries)
+    {
+        if (!archive.good())
+        {
+            break;
+        }
+
+        std::string member_name = entry.full_path.substr(name_start);
+        uint64_t mtime = entry.modified_time / 1000000000ULL;
+
+        if (entry.is_directory())
+        {
+            archive.add_directory(member_name, mtime);
+            continue;
+        }
+
+        // Open first; a file that vanished since the walk is skipped rather than archived empty
+        uint64_t handle = 0;
+        if (afc_file_open(afc_client, entry.full_path.c_str(), AFC_FOPEN_RDONLY, &handle) != AFC_E_SUCCESS)
+        {
+            std::cerr << "Error: Failed to open remote file: " << entry.full_path << std::endl;
+            failures++;
+            continue;
+        }
+
+        archive.begin_file(member_name, entry.file_size, mtime);
+        bool read_ok = pipelined_read(afc_client, handle, 0,
+            [&](const char* data, uint32_t length)
+            {
+                return archive.write_data(data, length);
+            },
+            nullptr);
+        afc_file_close(afc_client, handle);
+
+        if (!archive.end_file() || !read_ok)
+        {
+            std::cerr << "Error: Failed to archive " << entry.full_path << std::endl;
+            failures++;
+            continue;
+        }
+
+        total_bytes += entry.file_size;
+        file_count++;
+    }
+
+    bool finished = archive.finish();
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    double throughput = (elapsed > 0.0) ? (total_bytes / 1048576.0) / elapsed : 0.0;
+    if (stats)
+    {
+        stats->bytes_transferred = total_bytes;
+        stats->elapsed_seconds = elapsed;
+        stats->throughput_mbps = throughput;
+        stats->connections_used = 1;
+        stats->completed = finished && failures == 0;
+    }
+
+    char rate[32];
+    snprintf(rate, sizeof(rate), "%.2f", throughput);
+    std::cout << "Archived " << file_count << " files (" << format_file_size(total_bytes) << " read, "
+              << format_file_size(archive.bytes_written()) << " written) in " << elapsed << " s ("
+              << rate << " MB/s)" << std::endl;
+    if (failures > 0)
+    {
+        std::cerr << "Error: " << failures << " files could not be archived." << std::endl;
+    }
+
+    return finished && failures == 0;
+}
+
+/*****************************************************************************/
+/* Function Name: upload_file                                                */
+/*                                                                           */
+/* Description: Uploads a file from local filesystem to the device           */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Adaptive chunk sizing               */
+/* 2026-10-16      S. Amalfitano         Invalidate cached metadata          */
+/* 2026-10-16      S. Amalfitano         Moved body to upload_on_client      */
+/*****************************************************************************/
+bool afc_manager::upload_file(const std::string& source_path, const std::string& destination_path)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    local_file_info local = local_fs::stat_path(source_path);
+    bool success = upload_on_client(afc_client, source_path, destination_path, local.file_size);
+    invalidate_cached_info(destination_path, false);
+
+    return success;
+}
+
+/*****************************************************************************/
+/* Function Name: upload_on_client                                           */
+/*                                                                           */
+/* Description: Uploads a local file of the given size over the given AFC    */
+/*              connection. Files up to the maximum chunk size are read      */
+/*              whole and sent in a single write request; larger files go    */
+/*              out in maximum-size chunks that only shrink if the device    */
+/*              is slow to accept them                                       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool afc_manager::upload_on_client(afc_client_t client, const std::string& source_path,
+                                   const std::string& destination_path, uint64_t file_size)
+{
+    // Open local file for reading
+    std::ifstream infile(source_path, std::ios::binary);
+    if (!infile.is_open())
+    {
+        std::cerr << "Error: Failed to open local file: " << source_path << std::endl;
+        return false;
+    }
+
+    // Open remote file for writing
+    uint64_t handle = 0;
+    if (afc_file_open(client, destination_path.c_str(), AFC_FOPEN_WR, &handle) != AFC_E_SUCCESS)
+    {
+        std::cerr << "Error: Failed to create remote file: " << destination_path << std::endl;
+        return false;
+    }
+
+    uint32_t buffer_size = static_cast<uint32_t>(std::min<uint64_t>(std::max<uint64_t>(file_size, 1),
+                                                                    max_chunk_size));
+    chunk_sizer sizer(buffer_size, max_chunk_size);
+    std::vector<char> buffer(buffer_size);
+    uint64_t position = 0;
+    bool success = true;
+
+    while (infile.read(buffer.data(), buffer.size()) || infile.gcount() > 0)
+    {
+        uint32_t bytes_to_write = static_cast<uint32_t>(infile.gcount());
+
+        if (!write_chunk(client, handle, position, buffer.data(), bytes_to_write, sizer))
+        {
+            std::cerr << "Error: Failed to write to remote file: " << destination_path << std::endl;
+            success = false;
+            break;
+        }
+
+        position += bytes_to_write;
+    }
+
+    if (success && infile.bad())
+    {
+        std::cerr << "Error: Failed to read local file: " << source_path << std::endl;
+        success = false;
+    }
+
+    afc_file_close(client, handle);
+
+    return success;
+}
+
+/*****************************************************************************/
+/* Function Name: upload_tree                                                */
+/*                                                                           */
+/* Description: Uploads a local file or directory tree to the device. The    */
+/*              whole remote directory skeleton is created first, one depth  */
+/*              level at a time, so that the files can then be uploaded in   */
+/*              any order across the pooled connections. Symbolic links      */
+/*              inside the tree are skipped                                  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Skip symbolic links                 */
+/*****************************************************************************/
+bool afc_manager::upload_tree(const std::string& source_path, const std::string& destination_path,
+                              transfer_stats* stats)
+{
+    if (!afc_connected)
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    local_file_info root = local_fs::stat_path(source_path);
+    if (!root.exists)
+    {
+        std::cerr << "Error: Local path not found: " << source_path << std::endl;
+        return false;
+    }
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    std::vector<transfer_request> files;
+    std::vector<uint64_t> file_sizes;
+    std::vector<std::vector<std::string> > levels;
+    uint64_t total_bytes = 0;
+
+    if (root.is_directory)
+    {
+        // Breadth-first, so every directory lands in the level of its depth
+        std::vector<transfer_request> current(1);
+        current[0].source_path = source_path;
+        current[0].destination_path = destination_path;
+
+        while (!current.empty())
+        {
+            std::vector<transfer_request> next;
+            for (const transfer_request& directory : current)
+            {
+                for (const std::string& name : local_fs::list_directory(directory.source_path))
+                {
+                    transfer_request entry;
+                    entry.source_path = local_fs::join_path(directory.source_path, name);
+                    entry.destination_path = join_remote_path(directory.destination_path, name);
+
+                    // Links are not followed; one pointing at an ancestor would never end
+                    local_file_info info = local_fs::link_stat(entry.source_path);
+                    if (!info.exists)
+                    {
+                        continue;
+                    }
+                    if (info.is_symlink)
+                    {
+                        std::cerr << "Warning: Skipping symbolic link: " << entry.source_path << std::endl;
+                        continue;
+                    }
+
+                    if (info.is_directory)
+                    {
+                        next.push_back(entry);
+                    }
+                    else
+                    {
+                        files.push_back(entry);
+                        file_sizes.push_back(info.file_size);
+                        total_bytes += info.file_size;
+                    }
+                }
+            }
+
+            if (!next.empty())
+            {
+                levels.push_back(std::vector<std::string>());
+                for (const transfer_request& directory : next)
+                {
+                    levels.back().push_back(directory.destination_path);
+                }
+            }
+            current.swap(next);
+        }
+    }
+    else
+    {
+        transfer_request entry;
+        entry.source_path = source_path;
+        entry.destination_path = destination_path;
+        files.push_back(entry);
+        file_sizes.push_back(root.file_size);
+        total_bytes = root.file_size;
+    }
+
+    auto make_one = [](afc_client_t client, const std::string& target)
+    {
+        if (afc_make_directory(client, target.c_str()) != AFC_E_SUCCESS)
+        {
+            std::cerr << "Error: Failed to create directory: " << target << std::endl;
+            return false;
+        }
+        return true;
+    };
+
+    bool success = !root.is_directory || make_one(afc_client, destination_path);
+    for (size_t level = 0; level < levels.size() && success; level++)
+    {
+        const std::vector<std::string>& directories = levels[level];
+        success = run_on_pool(directories.size(),
+            [&](afc_client_t client, size_t i)
+            {
+                return make_one(client, directories[i]);
+            });
+    }
+
+    if (success)
+    {
+        success = run_on_pool(files.size(),
+            [&](afc_client_t client, size_t i)
+            {
+                return upload_on_client(client, files[i].source_path, files[i].destination_path, file_sizes[i]);
+            });
+    }
+
+    invalidate_cached_info(destination_path, true);
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    double throughput = (elapsed > 0.0) ? (total_bytes / 1048576.0) / elapsed : 0.0;
+    if (stats)
+    {
+        stats->bytes_transferred = total_bytes;
+        stats->elapsed_seconds = elapsed;
+        stats->throughput_mbps = throughput;
+        size_t workers = std::min<size_t>(parallel_connections, files.size());
+        stats->connections_used = static_cast<unsigned>(std::max<size_t>(workers, 1));
+        stats->completed = success;
     }
 
-    afc_error_t ret = afc_make_directory(afc_client, path.c_str());
-    if (ret != AFC_E_SUCCESS)
+    if (success)
     {
-        std::cerr << "Error: Failed to create directory: " << path << std::endl;
-        return false;
+        char rate[32];
+        snprintf(rate, sizeof(rate), "%.2f", throughput);
+        std::cout << "Uploaded " << files.size() << " files (" << format_file_size(total_bytes) << ") from "
+                  << source_path << " to " << destination_path << " in " << elapsed << " s (" << rate
+                  << " MB/s)" << std::endl;
     }
 
-    return true;
+    return success;
 }
 
 /*****************************************************************************/
-/* Function Name: remove_path                                                */
+/* Function Name: read_chunk                                                 */
 /*                                                                           */
-/* Description: Removes a file or directory from the device                  */
+/* Description: Reads up to limit bytes from an open remote file at the      */
+/*              given position, sized by the chunk sizer. Failed requests    */
+/*              shrink the chunk and are retried after re-seeking            */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
-/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
 /*****************************************************************************/
-bool afc_manager::remove_path(const std::string& path)
+bool afc_manager::read_chunk(afc_client_t client, uint64_t handle, uint64_t position, char* buffer,
+                             uint32_t limit, chunk_sizer& sizer, uint32_t* bytes_read)
 {
-    if (!afc_connected)
+    while (true)
     {
-        std::cerr << "Error: AFC not connected." << std::endl;
-        return false;
-    }
+        uint32_t request = std::min(sizer.next_size(), limit);
+        *bytes_read = 0;
 
-    afc_error_t ret = afc_remove_path(afc_client, path.c_str());
-    if (ret != AFC_E_SUCCESS)
-    {
-        std::cerr << "Error: Failed to remove path: " << path << std::endl;
-        return false;
-    }
+        std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+        afc_error_t ret = afc_file_read(client, handle, buffer, request, bytes_read);
+        double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
 
-    return true;
+        if (ret == AFC_E_SUCCESS)
+        {
+            sizer.record_success(request, *bytes_read, elapsed_ms);
+            return true;
+        }
+
+        sizer.record_failure();
+        if (sizer.should_give_up())
+        {
+            return false;
+        }
+
+        // The failed request may have moved the file pointer
+        if (afc_file_seek(client, handle, static_cast<int64_t>(position), SEEK_SET) != AFC_E_SUCCESS)
+        {
+            return false;
+        }
+    }
 }
 
 /*****************************************************************************/
-/* Function Name: download_file                                              */
+/* Function Name: write_chunk                                                */
 /*                                                                           */
-/* Description: Downloads a file from the device to local filesystem         */
+/* Description: Writes a buffer to an open remote file starting at the       */
+/*              given position, split into requests sized by the chunk       */
+/*              sizer. Failed requests shrink the chunk and are retried      */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
-/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
 /*****************************************************************************/
-bool afc_manager::download_file(const std::string& source_path, const std::string& destination_path)
+bool afc_manager::write_chunk(afc_client_t client, uint64_t handle, uint64_t position, const char* data,
+                              uint32_t length, chunk_sizer& sizer)
 {
-    if (!afc_connected)
-    {
-        std::cerr << "Error: AFC not connected." << std::endl;
-        return false;
-    }
-
-    // Open remote file for reading
-    uint64_t handle = 0;
-    afc_error_t ret = afc_file_open(afc_client, source_path.c_str(), AFC_FOPEN_RDONLY, &handle);
-    if (ret != AFC_E_SUCCESS)
-    {
-        std::cerr << "Error: Failed to open remote file: " << source_path << std::endl;
-        return false;
-    }
+    uint32_t offset = 0;
 
-    // Open local file for writing
-    std::ofstream outfile(destination_path, std::ios::binary);
-    if (!outfile.is_open())
+    while (offset < length)
     {
-        std::cerr << "Error: Failed to create local file: " << destination_path << std::endl;
-        afc_file_close(afc_client, handle);
-        return false;
-    }
+        uint32_t request = std::min(sizer.next_size(), length - offset);
+        uint32_t bytes_written = 0;
 
-    // Read and write in chunks
-    const uint32_t chunk_size = 8192;
-    char buffer[chunk_size];
-    uint32_t bytes_read = 0;
-    bool success = true;
+        std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+        afc_error_t ret = afc_file_write(client, handle, data + offset, request, &bytes_written);
+        double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
 
-    while (true)
-    {
-        ret = afc_file_read(afc_client, handle, buffer, chunk_size, &bytes_read);
-        if (ret != AFC_E_SUCCESS)
+        if (ret == AFC_E_SUCCESS && bytes_written > 0)
         {
-            std::cerr << "Error: Failed to read from remote file." << std::endl;
-            success = false;
-            break;
+            sizer.record_success(request, bytes_written, elapsed_ms);
+            offset += bytes_written;
+            continue;
         }
 
-        if (bytes_read == 0)
+        sizer.record_failure();
+        if (sizer.should_give_up())
         {
-            break;  // End of file
+            return false;
         }
 
-        outfile.write(buffer, bytes_read);
-        if (!outfile.good())
+        if (afc_file_seek(client, handle, static_cast<int64_t>(position + offset), SEEK_SET) != AFC_E_SUCCESS)
         {
-            std::cerr << "Error: Failed to write to local file." << std::endl;
-            success = false;
-            break;
+            return false;
         }
     }
 
-    afc_file_close(afc_client, handle);
-    outfile.close();
-
-    return success;
+    return true;
 }
 
 /*****************************************************************************/
-/* Function Name: upload_file                                                */
+/* Function Name: file_exists                                                */
 /*                                                                           */
-/* Description: Uploads a file from local filesystem to the device           */
+/* Description: Checks if a file or directory exists on the device           */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Serve from metadata cache           */
 /*****************************************************************************/
-bool afc_manager::upload_file(const std::string& source_path, const std::string& destination_path)
+bool afc_manager::file_exists(const std::string& path)
 {
     if (!afc_connected)
     {
-        std::cerr << "Error: AFC not connected." << std::endl;
-        return false;
-    }
-
-    // Open local file for reading
-    std::ifstream infile(source_path, std::ios::binary);
-    if (!infile.is_open())
-    {
-        std::cerr << "Error: Failed to open local file: " << source_path << std::endl;
         return false;
     }
 
-    // Open remote file for writing
-    uint64_t handle = 0;
-    afc_error_t ret = afc_file_open(afc_client, destination_path.c_str(), AFC_FOPEN_WR, &handle);
-    if (ret != AFC_E_SUCCESS)
+    bool exists = false;
+    file_info info;
+    if (metadata_cache && metadata_cache->lookup(path, exists, info))
     {
-        std::cerr << "Error: Failed to create remote file: " << destination_path << std::endl;
-        infile.close();
-        return false;
+        return exists;
     }
 
-    // Read and write in chunks
-    const uint32_t chunk_size = 8192;
-    char buffer[chunk_size];
-    bool success = true;
+    char** file_info_list = nullptr;
+    afc_error_t ret = afc_get_file_info(afc_client, path.c_str(), &file_info_list);
+    exists = (ret == AFC_E_SUCCESS && file_info_list);
 
-    while (infile.read(buffer, chunk_size) || infile.gcount() > 0)
+    if (!metadata_cache)
     {
-        uint32_t bytes_to_write = infile.gcount();
-        uint32_t bytes_written = 0;
-
-        ret = afc_file_write(afc_client, handle, buffer, bytes_to_write, &bytes_written);
-        if (ret != AFC_E_SUCCESS || bytes_written != bytes_to_write)
+        if (file_info_list)
         {
-            std::cerr << "Error: Failed to write to remote file." << std::endl;
-            success = false;
-            break;
+            afc_dictionary_free(file_info_list);
         }
+        return exists;
+    }
+
+    // Keep the parsed info too; a stat usually follows an existence check
+    info = parse_file_info(path, exists ? file_info_list : nullptr);
+    if (!exists && file_info_list)
+    {
+        afc_dictionary_free(file_info_list);
     }
 
-    afc_file_close(afc_client, handle);
-    infile.close();
+    if (exists || ret == AFC_E_OBJECT_NOT_FOUND)
+    {
+        metadata_cache->store(path, exists, info);
+    }
 
-    return success;
+    return exists;
 }
 
 /*****************************************************************************/
-/* Function Name: file_exists                                                */
+/* Function Name: get_file_info                                              */
 /*                                                                           */
-/* Description: Checks if a file or directory exists on the device           */
+/* Description: Retrieves detailed information about a file or directory     */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Serve from metadata cache           */
 /*****************************************************************************/
-bool afc_manager::file_exists(const std::string& path)
+file_info afc_manager::get_file_info(const std::string& path)
 {
     if (!afc_connected)
     {
-        return false;
-    }
-
-    char** info = nullptr;
-    afc_error_t ret = afc_get_file_info(afc_client, path.c_str(), &info);
-
-    if (ret == AFC_E_SUCCESS && info)
-    {
-        afc_dictionary_free(info);
-        return true;
+        return parse_file_info(path, nullptr);
     }
 
-    return false;
+    return query_file_info(afc_client, path);
 }
 
 /*****************************************************************************/
-/* Function Name: get_file_info                                              */
+/* Function Name: query_file_info                                            */
 /*                                                                           */
-/* Description: Retrieves detailed information about a file or directory     */
+/* Description: Stats a path over the given AFC connection, going through    */
+/*              the metadata cache when it is enabled                        */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
-/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
 /*****************************************************************************/
-file_info afc_manager::get_file_info(const std::string& path)
+file_info afc_manager::query_file_info(afc_client_t client, const std::string& path)
 {
+    bool exists = false;
     file_info info;
-    info.full_path = path;
-    info.filename = path.substr(path.find_last_of("/\\") + 1);
-    info.file_size = 0;
-    info.is_directory = false;
-
-    if (!afc_connected)
+    if (metadata_cache && metadata_cache->lookup(path, exists, info))
     {
         return info;
     }
 
     char** file_info_list = nullptr;
-    afc_error_t ret = afc_get_file_info(afc_client, path.c_str(), &file_info_list);
+    afc_error_t ret = afc_get_file_info(client, path.c_str(), &file_info_list);
+    exists = (ret == AFC_E_SUCCESS && file_info_list);
 
-    if (ret == AFC_E_SUCCESS && file_info_list)
+    // parse_file_info fills in the defaults when there is no dictionary
+    info = parse_file_info(path, exists ? file_info_list : nullptr);
+    if (!exists && file_info_list)
     {
-        return parse_file_info(path, file_info_list);
+        afc_dictionary_free(file_info_list);
+    }
+
+    if (metadata_cache && (exists || ret == AFC_E_OBJECT_NOT_FOUND))
+    {
+        metadata_cache->store(path, exists, info);
     }
 
     return info;
@@ -410,38 +2963,62 @@ file_info afc_manager::get_file_info(const std::string& path)
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Parse in place, numeric fields      */
 /*****************************************************************************/
 file_info afc_manager::parse_file_info(const std::string& path, char** file_info_list)
 {
     file_info info;
     info.full_path = path;
-    info.filename = path.substr(path.find_last_of("/\\") + 1);
-    info.file_size = 0;
-    info.is_directory = false;
+    info.filename.assign(path, path.find_last_of("/\\") + 1, std::string::npos);
 
-    if (file_info_list)
+    if (!file_info_list)
     {
-        for (int i = 0; file_info_list[i]; i += 2)
-        {
-            std::string key = file_info_list[i];
-            std::string value = file_info_list[i + 1];
+        return info;
+    }
 
-            if (key == "st_size")
-            {
-                info.file_size = std::stoull(value);
-            }
-            else if (key == "st_mtime")
-            {
-                info.modified_time = value;
-            }
-            else if (key == "st_ifmt")
+    // Keys and values are compared in place; only a symlink target is copied
+    for (char** pair = file_info_list; pair[0] && pair[1]; pair += 2)
+    {
+        const char* key = pair[0];
+        const char* value = pair[1];
+
+        if (strncmp(key, "st_", 3) != 0)
+        {
+            if (strcmp(key, "LinkTarget") == 0)
             {
-                info.is_directory = (value == "S_IFDIR");
+                info.link_target = value;
             }
+            continue;
+        }
+
+        key += 3;
+        if (strcmp(key, "size") == 0)
+        {
+            info.file_size = strtoull(value, nullptr, 10);
+        }
+        else if (strcmp(key, "mtime") == 0)
+        {
+            info.modified_time = strtoull(value, nullptr, 10);
+        }
+        else if (strcmp(key, "birthtime") == 0)
+        {
+            info.birth_time = strtoull(value, nullptr, 10);
+        }
+        else if (strcmp(key, "blocks") == 0)
+        {
+            info.blocks = strtoull(value, nullptr, 10);
+        }
+        else if (strcmp(key, "nlink") == 0)
+        {
+            info.link_count = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        }
+        else if (strcmp(key, "ifmt") == 0)
+        {
+            info.file_type = parse_file_type(value);
         }
-        afc_dictionary_free(file_info_list);
     }
 
+    afc_dictionary_free(file_info_list);
     return info;
 }
 
@@ -517,3 +3094,195 @@ afc_client_t afc_manager::get_afc_client() const
 {
     return afc_client;
 }
+
+/*****************************************************************************/
+/* Function Name: set_parallel_connections                                   */
+/*                                                                           */
+/* Description: Sets the number of AFC connections used by parallel          */
+/*              operations and the size of the client pool. A count of 1     */
+/*              disables range splitting. Call it while no parallel          */
+/*              operation is running                                         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void afc_manager::set_parallel_connections(unsigned count)
+{
+    parallel_connections = (count == 0) ? 1 : count;
+
+    // The pool is rebuilt at the new size the next time it is needed
+    std::lock_guard<std::mutex> guard(pool_lock);
+    delete client_pool;
+    client_pool = nullptr;
+}
+
+/*****************************************************************************/
+/* Function Name: get_parallel_connections                                   */
+/*                                                                           */
+/* Description: Returns the number of AFC connections used by parallel       */
+/*              downloads                                                    */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+unsigned afc_manager::get_parallel_connections() const
+{
+    return parallel_connections;
+}
+
+/*****************************************************************************/
+/* Function Name: set_initial_chunk_size                                     */
+/*                                                                           */
+/* Description: Sets the chunk size each transfer starts with before it      */
+/*              adapts to observed latency                                   */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void afc_manager::set_initial_chunk_size(uint32_t bytes)
+{
+    initial_chunk_size = bytes;
+}
+
+/*****************************************************************************/
+/* Function Name: set_max_chunk_size                                         */
+/*                                                                           */
+/* Description: Caps the chunk size adaptive transfers may grow to           */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void afc_manager::set_max_chunk_size(uint32_t bytes)
+{
+    max_chunk_size = bytes;
+}
+
+/*****************************************************************************/
+/* Function Name: set_resume_downloads                                       */
+/*                                                                           */
+/* Description: Enables or disables the resume journal kept next to          */
+/*              partial downloads                                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void afc_manager::set_resume_downloads(bool enabled)
+{
+    resume_downloads = enabled;
+}
+
+/*****************************************************************************/
+/* Function Name: get_client_pool                                            */
+/*                                                                           */
+/* Description: Returns the shared pool of extra AFC clients, starting it on */
+/*              first use with one client per parallel connection. Worker    */
+/*              threads borrow clients from it instead of sharing the        */
+/*              primary connection. Returns nullptr if AFC is not connected  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+afc_client_pool* afc_manager::get_client_pool()
+{
+    std::lock_guard<std::mutex> guard(pool_lock);
+
+    if (!afc_connected)
+    {
+        return nullptr;
+    }
+
+    if (!client_pool)
+    {
+        afc_client_pool* pool = new afc_client_pool(device, lockdown_client, parallel_connections);
+        if (!pool->open())
+        {
+            delete pool;
+            return nullptr;
+        }
+        client_pool = pool;
+    }
+
+    return client_pool;
+}
+
+/*****************************************************************************/
+/* Function Name: invalidate_cached_info                                     */
+/*                                                                           */
+/* Description: Drops cached metadata for a path changed through this        */
+/*              manager, and for its parent whose mtime changes with it.     */
+/*              Removals also drop everything below the path                 */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void afc_manager::invalidate_cached_info(const std::string& path, bool whole_tree)
+{
+    if (!metadata_cache)
+    {
+        return;
+    }
+
+    if (whole_tree)
+    {
+        metadata_cache->invalidate_tree(path);
+    }
+    else
+    {
+        metadata_cache->invalidate(path);
+    }
+    metadata_cache->invalidate(parent_remote_path(path));
+}
+
+/*****************************************************************************/
+/* Function Name: enable_metadata_cache                                      */
+/*                                                                           */
+/* Description: Turns on the in-memory metadata cache used by get_file_info  */
+/*              and file_exists, replacing any existing one. Call it while   */
+/*              no other thread is using this manager                        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void afc_manager::enable_metadata_cache(size_t max_entries, unsigned ttl_ms)
+{
+    delete metadata_cache;
+    metadata_cache = new file_info_cache(max_entries, ttl_ms);
+}
+
+/*****************************************************************************/
+/* Function Name: disable_metadata_cache                                     */
+/*                                                                           */
+/* Description: Turns off the metadata cache and frees its entries           */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void afc_manager::disable_metadata_cache()
+{
+    delete metadata_cache;
+    metadata_cache = nullptr;
+}
+
+/*****************************************************************************/
+/* Function Name: get_cache_stats                                            */
+/*                                                                           */
+/* Description: Returns the metadata cache counters, all zero when the       */
+/*              cache is disabled                                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+cache_stats afc_manager::get_cache_stats()
+{
+    return metadata_cache ? metadata_cache->get_stats() : cache_stats();
+}
@@ -0,0 +1,246 @@
+#include "afc_read_sink.h"
+#include <iostream>
+
+/*****************************************************************************/
+/* Function Name: begin                                                      */
+/*                                                                           */
+/* Description: Called once the remote file is open, before the first chunk. */
+/*              Returning false aborts the read                              */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool afc_read_sink::begin(const std::string& source_path, uint64_t offset)
+{
+    (void)source_path;
+    (void)offset;
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: finish                                                     */
+/*                                                                           */
+/* Description: Called after the last chunk with the outcome of the read.    */
+/*              The return value becomes the result of the whole read        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool afc_read_sink::finish(bool success)
+{
+    return success;
+}
+
+/*****************************************************************************/
+/* Function Name: file_sink (Constructor)                                    */
+/*                                                                           */
+/* Description: Remembers the destination; the file is opened by begin so a  */
+/*              remote file that cannot be opened leaves it untouched        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+file_sink::file_sink(const std::string& destination_path)
+    : path(destination_path), position(0)
+{
+}
+
+/*****************************************************************************/
+/* Function Name: begin                                                      */
+/*                                                                           */
+/* Description: Opens the local file. A non-zero offset keeps the bytes      */
+/*              already written and continues from there                     */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool file_sink::begin(const std::string& source_path, uint64_t offset)
+{
+    (void)source_path;
+
+    if (offset > 0)
+    {
+        outfile.open(path, std::ios::binary | std::ios::in | std::ios::out);
+        outfile.seekp(static_cast<std::streamoff>(offset));
+    }
+    else
+    {
+        outfile.open(path, std::ios::binary);
+    }
+
+    if (!outfile.is_open() || !outfile.good())
+    {
+        std::cerr << "Error: Failed to create local file: " << path << std::endl;
+        return false;
+    }
+
+    position = offset;
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: consume                                                    */
+/*                                                                           */
+/* Description: Appends a chunk to the local file                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool file_sink::consume(const char* data, size_t length)
+{
+    outfile.write(data, static_cast<std::streamsize>(length));
+    if (!outfile.good())
+    {
+        std::cerr << "Error: Failed to write to local file." << std::endl;
+        return false;
+    }
+
+    position += length;
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: finish                                                     */
+/*                                                                           */
+/* Description: Closes the local file. Fails if any write did not reach it   */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool file_sink::finish(bool success)
+{
+    outfile.close();
+    return success && !outfile.fail();
+}
+
+/*****************************************************************************/
+/* Function Name: flush                                                      */
+/*                                                                           */
+/* Description: Pushes buffered writes to the operating system so that       */
+/*              bytes_on_disk can be recorded as committed                   */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool file_sink::flush()
+{
+    outfile.flush();
+    return outfile.good();
+}
+
+/*****************************************************************************/
+/* Function Name: bytes_on_disk                                              */
+/*                                                                           */
+/* Description: Returns the file offset written up to, including the prefix  */
+/*              kept when starting past offset 0                             */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+uint64_t file_sink::bytes_on_disk() const
+{
+    return position;
+}
+
+/*****************************************************************************/
+/* Function Name: memory_sink (Constructor)                                  */
+/*                                                                           */
+/* Description: Creates an empty in-memory sink that refuses to grow past    */
+/*              limit bytes                                                  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+memory_sink::memory_sink(size_t limit)
+    : max_bytes(limit)
+{
+}
+
+/*****************************************************************************/
+/* Function Name: begin                                                      */
+/*                                                                           */
+/* Description: Drops anything collected by an earlier read                  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool memory_sink::begin(const std::string& source_path, uint64_t offset)
+{
+    (void)source_path;
+    (void)offset;
+    buffer.clear();
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: consume                                                    */
+/*                                                                           */
+/* Description: Appends a chunk to the buffer                                */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool memory_sink::consume(const char* data, size_t length)
+{
+    if (length > max_bytes - buffer.size())
+    {
+        std::cerr << "Error: Remote file exceeds the " << max_bytes << " byte memory limit." << std::endl;
+        return false;
+    }
+
+    buffer.insert(buffer.end(), data, data + length);
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: data                                                       */
+/*                                                                           */
+/* Description: Returns the collected bytes; the caller may swap them out    */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+std::vector<char>& memory_sink::data()
+{
+    return buffer;
+}
+
+/*****************************************************************************/
+/* Function Name: function_sink (Constructor)                                */
+/*                                                                           */
+/* Description: Wraps a callback as a sink                                   */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+function_sink::function_sink(const std::function<bool(const char*, size_t)>& callback)
+    : consumer(callback)
+{
+}
+
+/*****************************************************************************/
+/* Function Name: consume                                                    */
+/*                                                                           */
+/* Description: Hands a chunk to the callback                                */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool function_sink::consume(const char* data, size_t length)
+{
+    return consumer(data, length);
+}
@@ -0,0 +1,207 @@
+#include "chunk_pipeline.h"
+#include <chrono>
+
+/*****************************************************************************/
+/* Function Name: chunk_pipeline (Constructor)                               */
+/*                                                                           */
+/* Description: Allocates a fixed set of reusable buffers shared between a   */
+/*              producer and a consumer thread                               */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+chunk_pipeline::chunk_pipeline(size_t buffer_count, size_t buffer_size)
+    : buffers(buffer_count), producer_finished(false), cancelled(false),
+      producer_wait_seconds(0.0), consumer_wait_seconds(0.0)
+{
+    for (auto& buffer : buffers)
+    {
+        buffer.data.resize(buffer_size);
+        buffer.length = 0;
+        buffer.offset = 0;
+        free_buffers.push_back(&buffer);
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: acquire                                                    */
+/*                                                                           */
+/* Description: Blocks until an empty buffer is available for the producer.  */
+/*              Returns nullptr once the pipeline has been cancelled         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+pipeline_buffer* chunk_pipeline::acquire()
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    if (free_buffers.empty() && !cancelled)
+    {
+        std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+        free_available.wait(guard, [this]() { return !free_buffers.empty() || cancelled; });
+        producer_wait_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+
+    if (cancelled)
+    {
+        return nullptr;
+    }
+
+    pipeline_buffer* buffer = free_buffers.front();
+    free_buffers.pop_front();
+    buffer->length = 0;
+    return buffer;
+}
+
+/*****************************************************************************/
+/* Function Name: submit                                                     */
+/*                                                                           */
+/* Description: Hands a filled buffer to the consumer                        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void chunk_pipeline::submit(pipeline_buffer* buffer)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        filled_buffers.push_back(buffer);
+    }
+    filled_available.notify_one();
+}
+
+/*****************************************************************************/
+/* Function Name: finish                                                     */
+/*                                                                           */
+/* Description: Marks the end of the data. The consumer drains the buffers   */
+/*              already submitted and then sees the end of the stream        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void chunk_pipeline::finish()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        producer_finished = true;
+    }
+    filled_available.notify_all();
+}
+
+/*****************************************************************************/
+/* Function Name: next                                                       */
+/*                                                                           */
+/* Description: Blocks until a filled buffer is available for the consumer.  */
+/*              Returns nullptr at the end of the stream or on cancellation  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+pipeline_buffer* chunk_pipeline::next()
+{
+    std::unique_lock<std::mutex> guard(lock);
+
+    if (filled_buffers.empty() && !producer_finished && !cancelled)
+    {
+        std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+        filled_available.wait(guard, [this]() { return !filled_buffers.empty() || producer_finished || cancelled; });
+        consumer_wait_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    }
+
+    if (cancelled || filled_buffers.empty())
+    {
+        return nullptr;
+    }
+
+    pipeline_buffer* buffer = filled_buffers.front();
+    filled_buffers.pop_front();
+    return buffer;
+}
+
+/*****************************************************************************/
+/* Function Name: release                                                    */
+/*                                                                           */
+/* Description: Returns a buffer to the free list so it can be refilled      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void chunk_pipeline::release(pipeline_buffer* buffer)
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        free_buffers.push_back(buffer);
+    }
+    free_available.notify_one();
+}
+
+/*****************************************************************************/
+/* Function Name: cancel                                                     */
+/*                                                                           */
+/* Description: Aborts the pipeline and wakes both sides                     */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void chunk_pipeline::cancel()
+{
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        cancelled = true;
+    }
+    free_available.notify_all();
+    filled_available.notify_all();
+}
+
+/*****************************************************************************/
+/* Function Name: is_cancelled                                               */
+/*                                                                           */
+/* Description: Returns true if either side cancelled the pipeline           */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool chunk_pipeline::is_cancelled()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    return cancelled;
+}
+
+/*****************************************************************************/
+/* Function Name: producer_wait                                              */
+/*                                                                           */
+/* Description: Returns the time the producer spent waiting for free         */
+/*              buffers, which grows when the consumer is the bottleneck     */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+double chunk_pipeline::producer_wait() const
+{
+    return producer_wait_seconds;
+}
+
+/*****************************************************************************/
+/* Function Name: consumer_wait                                              */
+/*                                                                           */
+/* Description: Returns the time the consumer spent waiting for data, which  */
+/*              grows when the producer is the bottleneck                    */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+double chunk_pipeline::consumer_wait() const
+{
+    return consumer_wait_seconds;
+}
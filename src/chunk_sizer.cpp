@@ -0,0 +1,112 @@
+#include "chunk_sizer.h"
+#include <algorithm>
+
+// Smallest chunk ever requested, and the latency window the sizer aims for
+static const uint32_t smallest_chunk_size = 16 * 1024;
+static const double fast_request_ms = 40.0;
+static const double slow_request_ms = 400.0;
+static const unsigned max_consecutive_failures = 4;
+
+/*****************************************************************************/
+/* Function Name: chunk_sizer (Constructor)                                  */
+/*                                                                           */
+/* Description: Initializes the sizer with a starting chunk size and an      */
+/*              upper bound. The starting size is clamped to the bounds      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+chunk_sizer::chunk_sizer(uint32_t initial_size, uint32_t maximum_size)
+    : current_size(initial_size), min_size(smallest_chunk_size),
+      max_size(std::max(maximum_size, smallest_chunk_size)), consecutive_failures(0)
+{
+    current_size = std::min(std::max(current_size, min_size), max_size);
+}
+
+/*****************************************************************************/
+/* Function Name: record_success                                             */
+/*                                                                           */
+/* Description: Adjusts the chunk size after a completed request. Fast full  */
+/*              requests double the size, slow requests halve it             */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void chunk_sizer::record_success(uint32_t requested, uint32_t transferred, double elapsed_ms)
+{
+    consecutive_failures = 0;
+
+    if (elapsed_ms > slow_request_ms)
+    {
+        current_size = std::max(current_size / 2, min_size);
+    }
+    else if (elapsed_ms < fast_request_ms && transferred == requested && requested >= current_size)
+    {
+        // Only grow when the request was not cut short by end of file
+        current_size = (current_size > max_size / 2) ? max_size : current_size * 2;
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: record_failure                                             */
+/*                                                                           */
+/* Description: Shrinks the chunk size after a failed request and lowers     */
+/*              the ceiling so the sizer does not grow back into the size    */
+/*              that failed                                                  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void chunk_sizer::record_failure()
+{
+    consecutive_failures++;
+    max_size = std::max(current_size / 2, min_size);
+    current_size = std::max(current_size / 4, min_size);
+}
+
+/*****************************************************************************/
+/* Function Name: next_size                                                  */
+/*                                                                           */
+/* Description: Returns the size to use for the next request                 */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+uint32_t chunk_sizer::next_size() const
+{
+    return current_size;
+}
+
+/*****************************************************************************/
+/* Function Name: maximum                                                    */
+/*                                                                           */
+/* Description: Returns the largest size the sizer will ever hand out, used  */
+/*              to allocate transfer buffers once                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+uint32_t chunk_sizer::maximum() const
+{
+    return max_size;
+}
+
+/*****************************************************************************/
+/* Function Name: should_give_up                                             */
+/*                                                                           */
+/* Description: Returns true once repeated failures make further retries     */
+/*              pointless                                                    */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool chunk_sizer::should_give_up() const
+{
+    return consecutive_failures >= max_consecutive_failures;
+}
@@ -0,0 +1,154 @@
+#include "content_hasher.h"
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include <algorithm>
+
+// Block size used when hashing a prefix that is already on disk
+static const size_t file_hash_block_size = 1024 * 1024;
+
+/*****************************************************************************/
+/* Function Name: content_hasher (Constructor)                               */
+/*                                                                           */
+/* Description: Allocates the XXH3 streaming state and starts a new digest   */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+content_hasher::content_hasher()
+    : state(XXH3_createState()), bytes_hashed(0)
+{
+    reset();
+}
+
+/*****************************************************************************/
+/* Function Name: ~content_hasher (Destructor)                               */
+/*                                                                           */
+/* Description: Frees the XXH3 streaming state                               */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+content_hasher::~content_hasher()
+{
+    if (state)
+    {
+        XXH3_freeState(state);
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: reset                                                      */
+/*                                                                           */
+/* Description: Discards everything hashed so far                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void content_hasher::reset()
+{
+    if (state)
+    {
+        XXH3_128bits_reset(state);
+    }
+    bytes_hashed = 0;
+}
+
+/*****************************************************************************/
+/* Function Name: update                                                     */
+/*                                                                           */
+/* Description: Adds the next chunk of file contents to the digest           */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void content_hasher::update(const char* data, size_t length)
+{
+    if (state && length > 0)
+    {
+        XXH3_128bits_update(state, data, length);
+        bytes_hashed += length;
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: update_from_file                                           */
+/*                                                                           */
+/* Description: Hashes the first length bytes of a local file. Used when a   */
+/*              resumed download continues after a prefix that was written   */
+/*              by an earlier attempt. Returns false if the file is shorter  */
+/*              or cannot be read                                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool content_hasher::update_from_file(const std::string& path, uint64_t length)
+{
+    std::ifstream infile(path, std::ios::binary);
+    if (!infile.is_open())
+    {
+        return false;
+    }
+
+    std::vector<char> buffer(static_cast<size_t>(std::min<uint64_t>(length, file_hash_block_size)));
+    uint64_t remaining = length;
+
+    while (remaining > 0)
+    {
+        size_t wanted = static_cast<size_t>(std::min<uint64_t>(remaining, buffer.size()));
+        infile.read(buffer.data(), static_cast<std::streamsize>(wanted));
+        if (static_cast<size_t>(infile.gcount()) != wanted)
+        {
+            return false;
+        }
+
+        update(buffer.data(), wanted);
+        remaining -= wanted;
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: hex_digest                                                 */
+/*                                                                           */
+/* Description: Returns the digest of everything hashed so far as 32 hex     */
+/*              characters, in the canonical (big endian) XXH128 order       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+std::string content_hasher::hex_digest() const
+{
+    if (!state)
+    {
+        return "";
+    }
+
+    XXH128_hash_t digest = XXH3_128bits_digest(state);
+    char text[33];
+    snprintf(text, sizeof(text), "%016llx%016llx",
+             static_cast<unsigned long long>(digest.high64),
+             static_cast<unsigned long long>(digest.low64));
+    return text;
+}
+
+/*****************************************************************************/
+/* Function Name: size                                                       */
+/*                                                                           */
+/* Description: Returns the number of bytes hashed since the last reset      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+uint64_t content_hasher::size() const
+{
+    return bytes_hashed;
+}
@@ -0,0 +1,181 @@
+#include "file_info_cache.h"
+
+/*****************************************************************************/
+/* Function Name: file_info_cache (Constructor)                              */
+/*                                                                           */
+/* Description: Creates an empty cache holding at most max_entries paths,    */
+/*              each valid for ttl_ms milliseconds                           */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+file_info_cache::file_info_cache(size_t max_entries, unsigned ttl_ms)
+    : capacity(max_entries == 0 ? 1 : max_entries), ttl(ttl_ms)
+{
+    stats.capacity = capacity;
+}
+
+/*****************************************************************************/
+/* Function Name: lookup                                                     */
+/*                                                                           */
+/* Description: Returns true and fills exists/info if the path has a fresh   */
+/*              entry. Expired entries are dropped and count as misses       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool file_info_cache::lookup(const std::string& path, bool& exists, file_info& info)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto found = index.find(path);
+    if (found == index.end())
+    {
+        stats.misses++;
+        return false;
+    }
+
+    std::list<cache_entry>::iterator it = found->second;
+    if (std::chrono::steady_clock::now() - it->stored_at > ttl)
+    {
+        entries.erase(it);
+        index.erase(found);
+        stats.expirations++;
+        stats.misses++;
+        return false;
+    }
+
+    // Move to the front of the recency list
+    entries.splice(entries.begin(), entries, it);
+    exists = it->exists;
+    info = it->info;
+    stats.hits++;
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: store                                                      */
+/*                                                                           */
+/* Description: Records the metadata of a path, evicting the least recently  */
+/*              used entry when the cache is full                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void file_info_cache::store(const std::string& path, bool exists, const file_info& info)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto found = index.find(path);
+    if (found != index.end())
+    {
+        entries.erase(found->second);
+        index.erase(found);
+    }
+    else if (entries.size() >= capacity)
+    {
+        index.erase(entries.back().path);
+        entries.pop_back();
+        stats.evictions++;
+    }
+
+    cache_entry entry;
+    entry.path = path;
+    entry.exists = exists;
+    entry.info = info;
+    entry.stored_at = std::chrono::steady_clock::now();
+    entries.push_front(entry);
+    index[path] = entries.begin();
+}
+
+/*****************************************************************************/
+/* Function Name: invalidate                                                 */
+/*                                                                           */
+/* Description: Drops the entry for a single path                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void file_info_cache::invalidate(const std::string& path)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    auto found = index.find(path);
+    if (found != index.end())
+    {
+        entries.erase(found->second);
+        index.erase(found);
+        stats.invalidations++;
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: invalidate_tree                                            */
+/*                                                                           */
+/* Description: Drops the entry for a path and for everything below it       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void file_info_cache::invalidate_tree(const std::string& path)
+{
+    std::lock_guard<std::mutex> guard(lock);
+
+    std::string prefix = path;
+    if (prefix.empty() || prefix.back() != '/')
+    {
+        prefix += "/";
+    }
+
+    for (auto it = entries.begin(); it != entries.end();)
+    {
+        if (it->path == path || it->path.compare(0, prefix.size(), prefix) == 0)
+        {
+            index.erase(it->path);
+            it = entries.erase(it);
+            stats.invalidations++;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: clear                                                      */
+/*                                                                           */
+/* Description: Drops every entry. Counters are kept                         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void file_info_cache::clear()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    entries.clear();
+    index.clear();
+}
+
+/*****************************************************************************/
+/* Function Name: get_stats                                                  */
+/*                                                                           */
+/* Description: Returns the hit, miss and eviction counters                  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+cache_stats file_info_cache::get_stats()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    cache_stats current = stats;
+    current.entries = entries.size();
+    return current;
+}
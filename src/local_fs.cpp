@@ -0,0 +1,315 @@
+#include "local_fs.h"
+#include <cstdio>
+#include <cerrno>
+#include <dirent.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <direct.h>
+#include <sys/utime.h>
+#else
+#include <unistd.h>
+#include <utime.h>
+#endif
+
+namespace local_fs {
+
+/*****************************************************************************/
+/* Function Name: stat_path                                                  */
+/*                                                                           */
+/* Description: Returns size, type and modification time of a local path.    */
+/*              Uses the 64-bit stat variant on Windows so files over 2 GB   */
+/*              report their real size                                       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+local_file_info stat_path(const std::string& path)
+{
+    local_file_info info;
+
+#ifdef _WIN32
+    struct __stat64 st;
+    if (_stat64(path.c_str(), &st) != 0)
+    {
+        return info;
+    }
+#else
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0)
+    {
+        return info;
+    }
+#endif
+
+    info.exists = true;
+    info.is_directory = S_ISDIR(st.st_mode);
+    info.file_size = static_cast<uint64_t>(st.st_size);
+    info.modified_time = static_cast<int64_t>(st.st_mtime);
+    return info;
+}
+
+/*****************************************************************************/
+/* Function Name: link_stat                                                  */
+/*                                                                           */
+/* Description: Like stat_path, but does not follow a symbolic link (or, on  */
+/*              Windows, a junction or other reparse point); such a path is  */
+/*              reported with is_symlink set, so tree walks can skip it      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+local_file_info link_stat(const std::string& path)
+{
+#ifdef _WIN32
+    DWORD attributes = GetFileAttributesA(path.c_str());
+    if (attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_REPARSE_POINT))
+    {
+        local_file_info info;
+        info.exists = true;
+        info.is_symlink = true;
+        return info;
+    }
+    return stat_path(path);
+#else
+    local_file_info info;
+    struct stat st;
+    if (lstat(path.c_str(), &st) != 0)
+    {
+        return info;
+    }
+
+    info.exists = true;
+    info.is_symlink = S_ISLNK(st.st_mode);
+    info.is_directory = S_ISDIR(st.st_mode);
+    info.file_size = static_cast<uint64_t>(st.st_size);
+    info.modified_time = static_cast<int64_t>(st.st_mtime);
+    return info;
+#endif
+}
+
+/*****************************************************************************/
+/* Function Name: make_directories                                           */
+/*                                                                           */
+/* Description: Creates a directory and any missing parents                  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool make_directories(const std::string& path)
+{
+    if (path.empty())
+    {
+        return true;
+    }
+
+    local_file_info info = stat_path(path);
+    if (info.exists)
+    {
+        return info.is_directory;
+    }
+
+    std::string parent = parent_path(path);
+    if (!parent.empty() && parent != path && !make_directories(parent))
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    int ret = _mkdir(path.c_str());
+#else
+    int ret = mkdir(path.c_str(), 0755);
+#endif
+
+    // Another thread may have created it in the meantime
+    return ret == 0 || errno == EEXIST;
+}
+
+/*****************************************************************************/
+/* Function Name: remove_file                                                */
+/*                                                                           */
+/* Description: Deletes a local file                                         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool remove_file(const std::string& path)
+{
+    return std::remove(path.c_str()) == 0;
+}
+
+/*****************************************************************************/
+/* Function Name: remove_directory                                           */
+/*                                                                           */
+/* Description: Deletes an empty local directory                             */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool remove_directory(const std::string& path)
+{
+#ifdef _WIN32
+    return _rmdir(path.c_str()) == 0;
+#else
+    return rmdir(path.c_str()) == 0;
+#endif
+}
+
+/*****************************************************************************/
+/* Function Name: rename_replace                                             */
+/*                                                                           */
+/* Description: Renames a file over an existing one. Plain rename() refuses  */
+/*              to replace the target on Windows                             */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool rename_replace(const std::string& from, const std::string& to)
+{
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+/*****************************************************************************/
+/* Function Name: make_hard_link                                             */
+/*                                                                           */
+/* Description: Creates link_path as another name for the existing file      */
+/*              target. Fails across volumes and on filesystems without      */
+/*              hard links, such as FAT                                      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool make_hard_link(const std::string& target, const std::string& link_path)
+{
+#ifdef _WIN32
+    return CreateHardLinkA(link_path.c_str(), target.c_str(), NULL) != 0;
+#else
+    return link(target.c_str(), link_path.c_str()) == 0;
+#endif
+}
+
+/*****************************************************************************/
+/* Function Name: set_modified_time                                          */
+/*                                                                           */
+/* Description: Sets the access and modification time of a local file        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool set_modified_time(const std::string& path, int64_t seconds)
+{
+#ifdef _WIN32
+    struct __utimbuf64 times;
+    times.actime = seconds;
+    times.modtime = seconds;
+    return _utime64(path.c_str(), &times) == 0;
+#else
+    struct utimbuf times;
+    times.actime = static_cast<time_t>(seconds);
+    times.modtime = static_cast<time_t>(seconds);
+    return utime(path.c_str(), &times) == 0;
+#endif
+}
+
+/*****************************************************************************/
+/* Function Name: list_directory                                             */
+/*                                                                           */
+/* Description: Lists the entries of a local directory without . and ..      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+std::vector<std::string> list_directory(const std::string& path)
+{
+    std::vector<std::string> result;
+
+    DIR* dir = opendir(path.c_str());
+    if (!dir)
+    {
+        return result;
+    }
+
+    while (struct dirent* entry = readdir(dir))
+    {
+        std::string name = entry->d_name;
+        if (name != "." && name != "..")
+        {
+            result.push_back(name);
+        }
+    }
+    closedir(dir);
+
+    return result;
+}
+
+/*****************************************************************************/
+/* Function Name: join_path                                                  */
+/*                                                                           */
+/* Description: Appends a name to a local directory path                     */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+std::string join_path(const std::string& directory, const std::string& name)
+{
+    if (directory.empty())
+    {
+        return name;
+    }
+
+    std::string full_path = directory;
+    if (full_path.back() != '/' && full_path.back() != '\\')
+    {
+        full_path += "/";
+    }
+    full_path += name;
+    return full_path;
+}
+
+/*****************************************************************************/
+/* Function Name: parent_path                                                */
+/*                                                                           */
+/* Description: Returns the directory part of a local path, or an empty      */
+/*              string if there is none                                      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+std::string parent_path(const std::string& path)
+{
+    size_t end = path.find_last_not_of("/\\");
+    if (end == std::string::npos)
+    {
+        return "";
+    }
+
+    size_t slash = path.find_last_of("/\\", end);
+    if (slash == std::string::npos)
+    {
+        return "";
+    }
+    if (slash == 0)
+    {
+        return path.substr(0, 1);
+    }
+    return path.substr(0, slash);
+}
+
+}
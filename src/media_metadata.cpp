@@ -0,0 +1,1159 @@
+#include "media_metadata.h"
+#include <cstring>
+#include <algorithm>
+
+// Smallest and largest read the parser will ask for in one go. Headers are a
+// few kilobytes; anything bigger than the limit is not worth fetching
+static const uint64_t min_request_size = 16 * 1024;
+static const uint64_t max_request_size = 4 * 1024 * 1024;
+
+// Seconds between the QuickTime epoch (1904-01-01) and the Unix epoch
+static const uint64_t quicktime_epoch_offset = 2082844800ULL;
+
+/*****************************************************************************/
+/* Function Name: get_be16                                                   */
+/*                                                                           */
+/* Description: Decodes a big-endian 16-bit value                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static uint32_t get_be16(const char* p)
+{
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+    return (static_cast<uint32_t>(b[0]) << 8) | static_cast<uint32_t>(b[1]);
+}
+
+/*****************************************************************************/
+/* Function Name: get_be32                                                   */
+/*                                                                           */
+/* Description: Decodes a big-endian 32-bit value                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static uint32_t get_be32(const char* p)
+{
+    return (get_be16(p) << 16) | get_be16(p + 2);
+}
+
+/*****************************************************************************/
+/* Function Name: get_be64                                                   */
+/*                                                                           */
+/* Description: Decodes a big-endian 64-bit value                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static uint64_t get_be64(const char* p)
+{
+    return (static_cast<uint64_t>(get_be32(p)) << 32) | get_be32(p + 4);
+}
+
+/*****************************************************************************/
+/* Function Name: get_be_sized                                               */
+/*                                                                           */
+/* Description: Decodes a big-endian value of 0, 4 or 8 bytes, as used by    */
+/*              the variable-width fields of the HEIF item location box      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static uint64_t get_be_sized(const char* p, unsigned size)
+{
+    if (size == 4)
+    {
+        return get_be32(p);
+    }
+    if (size == 8)
+    {
+        return get_be64(p);
+    }
+    return 0;
+}
+
+/*****************************************************************************/
+/* Function Name: is_type                                                    */
+/*                                                                           */
+/* Description: Compares a four character box or item type                   */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static bool is_type(const char* type, const char* expected)
+{
+    return std::memcmp(type, expected, 4) == 0;
+}
+
+/*****************************************************************************/
+/* Function Name: days_from_civil                                            */
+/*                                                                           */
+/* Description: Days from 1970-01-01 to a proleptic Gregorian date. Used     */
+/*              instead of timegm, which Windows does not have               */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static int64_t days_from_civil(int64_t year, int month, int day)
+{
+    year -= (month <= 2) ? 1 : 0;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const int64_t year_of_era = year - era * 400;
+    const int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+/*****************************************************************************/
+/* Function Name: parse_digits                                               */
+/*                                                                           */
+/* Description: Parses a fixed-width decimal field                           */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static bool parse_digits(const char* text, int count, int& value)
+{
+    value = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (text[i] < '0' || text[i] > '9')
+        {
+            return false;
+        }
+        value = value * 10 + (text[i] - '0');
+    }
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: parse_exif_time                                            */
+/*                                                                           */
+/* Description: Parses an EXIF "YYYY:MM:DD HH:MM:SS" timestamp into seconds  */
+/*              since the epoch, taking the time as UTC                      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static bool parse_exif_time(const char* text, size_t length, int64_t& seconds)
+{
+    static const int positions[6] = { 0, 5, 8, 11, 14, 17 };
+    static const int widths[6] = { 4, 2, 2, 2, 2, 2 };
+
+    if (length < 19)
+    {
+        return false;
+    }
+
+    int fields[6];
+    for (int i = 0; i < 6; i++)
+    {
+        if (!parse_digits(text + positions[i], widths[i], fields[i]))
+        {
+            return false;
+        }
+    }
+
+    if (fields[1] < 1 || fields[1] > 12 || fields[2] < 1 || fields[2] > 31)
+    {
+        return false;
+    }
+
+    seconds = days_from_civil(fields[0], fields[1], fields[2]) * 86400 +
+              fields[3] * 3600 + fields[4] * 60 + fields[5];
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: parse_exif_offset                                          */
+/*                                                                           */
+/* Description: Parses an EXIF "+HH:MM" UTC offset into seconds              */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static bool parse_exif_offset(const char* text, size_t length, int64_t& seconds)
+{
+    int hours = 0;
+    int minutes = 0;
+
+    if (length < 6 || (text[0] != '+' && text[0] != '-') || text[3] != ':' ||
+        !parse_digits(text + 1, 2, hours) || !parse_digits(text + 4, 2, minutes))
+    {
+        return false;
+    }
+
+    seconds = hours * 3600 + minutes * 60;
+    if (text[0] == '-')
+    {
+        seconds = -seconds;
+    }
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: media_bytes                                                */
+/*                                                                           */
+/* Description: Constructor                                                  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+media_bytes::media_bytes(uint64_t total_size)
+    : file_size(total_size)
+{
+}
+
+/*****************************************************************************/
+/* Function Name: add                                                        */
+/*                                                                           */
+/* Description: Records a fetched range. The data is swapped in rather than  */
+/*              copied                                                       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void media_bytes::add(uint64_t offset, std::vector<char>& data)
+{
+    if (data.empty())
+    {
+        return;
+    }
+
+    std::vector<char>& chunk = chunks[offset];
+    if (chunk.size() < data.size())
+    {
+        chunk.swap(data);
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: find                                                       */
+/*                                                                           */
+/* Description: Returns the fetched bytes covering [offset, offset + length) */
+/*              or nullptr if no single fetched range holds all of them      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+const char* media_bytes::find(uint64_t offset, uint64_t length) const
+{
+    auto it = chunks.upper_bound(offset);
+    if (it == chunks.begin())
+    {
+        return nullptr;
+    }
+    --it;
+
+    uint64_t skip = offset - it->first;
+    if (skip > it->second.size() || length > it->second.size() - skip)
+    {
+        return nullptr;
+    }
+    return it->second.data() + skip;
+}
+
+/*****************************************************************************/
+/* Function Name: size                                                       */
+/*                                                                           */
+/* Description: Returns the size of the whole remote file                    */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+uint64_t media_bytes::size() const
+{
+    return file_size;
+}
+
+/*****************************************************************************/
+/* Function Name: media_metadata_parser                                      */
+/*                                                                           */
+/* Description: Constructor                                                  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+media_metadata_parser::media_metadata_parser(const media_bytes& file_bytes)
+    : bytes(file_bytes), has_request(false)
+{
+}
+
+/*****************************************************************************/
+/* Function Name: need                                                       */
+/*                                                                           */
+/* Description: Returns the bytes of a range if they have been fetched.      */
+/*              Otherwise records the first missing range as the next        */
+/*              request and returns nullptr. Ranges past the end of the file */
+/*              or over the request limit are treated as corrupt             */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+const char* media_metadata_parser::need(uint64_t offset, uint64_t length)
+{
+    uint64_t file_size = bytes.size();
+    if (length > max_request_size || offset > file_size || length > file_size - offset)
+    {
+        return nullptr;
+    }
+
+    const char* data = bytes.find(offset, length);
+    if (!data && !has_request)
+    {
+        request.offset = offset;
+        request.length = static_cast<uint32_t>(std::min(std::max(length, min_request_size),
+                                                        file_size - offset));
+        has_request = true;
+    }
+    return data;
+}
+
+/*****************************************************************************/
+/* Function Name: read_box                                                   */
+/*                                                                           */
+/* Description: Reads an ISO BMFF box header at position, checking that the  */
+/*              box fits inside its parent                                   */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool media_metadata_parser::read_box(uint64_t position, uint64_t end, box_info& box)
+{
+    if (position >= end || end - position < 8)
+    {
+        return false;
+    }
+
+    const char* header = need(position, 8);
+    if (!header)
+    {
+        return false;
+    }
+
+    uint64_t size = get_be32(header);
+    uint32_t header_size = 8;
+    if (size == 1)
+    {
+        // 64-bit size follows the type
+        const char* large_size = need(position + 8, 8);
+        if (!large_size)
+        {
+            return false;
+        }
+        size = get_be64(large_size);
+        header_size = 16;
+    }
+    else if (size == 0)
+    {
+        // Extends to the end of the parent
+        size = end - position;
+    }
+
+    if (size < header_size || size > end - position)
+    {
+        return false;
+    }
+
+    box.start = position;
+    box.size = size;
+    box.header_size = header_size;
+    std::memcpy(box.type, header + 4, 4);
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: parse                                                      */
+/*                                                                           */
+/* Description: Parses whatever the fetched bytes allow. Returns need_range  */
+/*              when another range should be fetched before parsing again    */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+metadata_status media_metadata_parser::parse(media_metadata& metadata)
+{
+    has_request = false;
+    metadata = media_metadata();
+
+    const char* magic = need(0, 2);
+    if (magic && static_cast<unsigned char>(magic[0]) == 0xFF &&
+        static_cast<unsigned char>(magic[1]) == 0xD8)
+    {
+        parse_jpeg(metadata);
+    }
+    else if (magic)
+    {
+        const char* header = need(0, 8);
+        if (header && (is_type(header + 4, "ftyp") || is_type(header + 4, "moov") ||
+                       is_type(header + 4, "mdat") || is_type(header + 4, "wide") ||
+                       is_type(header + 4, "free") || is_type(header + 4, "skip")))
+        {
+            parse_bmff(metadata);
+        }
+    }
+
+    return has_request ? metadata_status::need_range : metadata_status::complete;
+}
+
+/*****************************************************************************/
+/* Function Name: next_request                                               */
+/*                                                                           */
+/* Description: Returns the range to fetch after parse returned need_range   */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+metadata_request media_metadata_parser::next_request() const
+{
+    return request;
+}
+
+/*****************************************************************************/
+/* Function Name: parse_jpeg                                                 */
+/*                                                                           */
+/* Description: Walks the JPEG marker segments up to the start of scan,      */
+/*              reading the EXIF APP1 segment and the frame header           */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Pass the TIFF file offset           */
+/*****************************************************************************/
+void media_metadata_parser::parse_jpeg(media_metadata& metadata)
+{
+    uint64_t position = 2;
+
+    while (true)
+    {
+        const char* marker = need(position, 4);
+        if (!marker || static_cast<unsigned char>(marker[0]) != 0xFF)
+        {
+            return;
+        }
+
+        unsigned char code = static_cast<unsigned char>(marker[1]);
+        if (code == 0xFF)
+        {
+            // Fill byte
+            position++;
+            continue;
+        }
+        if (code == 0x01 || (code >= 0xD0 && code <= 0xD8))
+        {
+            // Markers without a length
+            position += 2;
+            continue;
+        }
+        if (code == 0xD9 || code == 0xDA)
+        {
+            // End of image or start of scan: no more headers
+            return;
+        }
+
+        uint32_t segment_length = get_be16(marker + 2);
+        if (segment_length < 2)
+        {
+            return;
+        }
+
+        if (code == 0xE1)
+        {
+            const char* segment = need(position + 4, segment_length - 2);
+            if (!segment)
+            {
+                return;
+            }
+            if (segment_length - 2 > 6 && std::memcmp(segment, "Exif\0\0", 6) == 0)
+            {
+                parse_exif(segment + 6, segment_length - 8, position + 10, metadata);
+            }
+        }
+        else if (code >= 0xC0 && code <= 0xCF && code != 0xC4 && code != 0xC8 && code != 0xCC)
+        {
+            // Start of frame: precision, height, width. It follows every
+            // metadata segment, so there is nothing more to read
+            const char* frame = need(position + 4, 5);
+            if (frame)
+            {
+                metadata.height = get_be16(frame + 1);
+                metadata.width = get_be16(frame + 3);
+            }
+            return;
+        }
+
+        position += 2 + segment_length;
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: parse_exif                                                 */
+/*                                                                           */
+/* Description: Reads the capture time, its UTC offset and the pixel         */
+/*              dimensions from an EXIF TIFF structure, and locates the JPEG */
+/*              thumbnail of IFD1. position is the file offset of the TIFF   */
+/*              header, which thumbnail offsets are relative to              */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Locate the IFD1 thumbnail           */
+/*****************************************************************************/
+void media_metadata_parser::parse_exif(const char* tiff, size_t length, uint64_t position,
+                                       media_metadata& metadata)
+{
+    if (length < 8)
+    {
+        return;
+    }
+
+    bool little_endian;
+    if (tiff[0] == 'I' && tiff[1] == 'I')
+    {
+        little_endian = true;
+    }
+    else if (tiff[0] == 'M' && tiff[1] == 'M')
+    {
+        little_endian = false;
+    }
+    else
+    {
+        return;
+    }
+
+    auto u16 = [&](size_t offset) -> uint32_t {
+        const unsigned char* b = reinterpret_cast<const unsigned char*>(tiff + offset);
+        return little_endian ? (b[0] | (b[1] << 8)) : ((b[0] << 8) | b[1]);
+    };
+    auto u32 = [&](size_t offset) -> uint32_t {
+        return little_endian ? (u16(offset) | (u16(offset + 2) << 16))
+                             : ((u16(offset) << 16) | u16(offset + 2));
+    };
+
+    if (u16(2) != 42)
+    {
+        return;
+    }
+
+    // Location and size of a tag's value: inline when it fits in four bytes
+    auto value_of = [&](size_t entry, size_t& offset, size_t& count) -> bool {
+        static const size_t type_sizes[13] = { 0, 1, 1, 2, 4, 8, 1, 1, 2, 4, 8, 4, 8 };
+        uint32_t type = u16(entry + 2);
+        count = u32(entry + 4);
+        if (type >= 13 || type_sizes[type] == 0 || count > length)
+        {
+            return false;
+        }
+        size_t bytes_needed = type_sizes[type] * count;
+        offset = bytes_needed <= 4 ? entry + 8 : u32(entry + 8);
+        return offset <= length && bytes_needed <= length - offset;
+    };
+    auto number_of = [&](size_t entry) -> uint32_t {
+        return u16(entry + 2) == 3 ? u16(entry + 8) : u32(entry + 8);
+    };
+
+    size_t date_offset = 0;
+    size_t date_length = 0;
+    size_t original_offset = 0;
+    size_t original_length = 0;
+    size_t zone_offset = 0;
+    size_t zone_length = 0;
+    uint32_t pixel_width = 0;
+    uint32_t pixel_height = 0;
+    uint32_t thumbnail_offset = 0;
+    uint32_t thumbnail_length = 0;
+
+    // IFD0, the Exif sub-IFD it points to, then IFD1 which follows IFD0
+    size_t ifds[3] = { u32(4), 0, 0 };
+    for (int pass = 0; pass < 3; pass++)
+    {
+        size_t ifd = ifds[pass];
+        if (ifd == 0 || ifd > length - 2)
+        {
+            continue;
+        }
+        size_t count = u16(ifd);
+        if (count > (length - ifd - 2) / 12)
+        {
+            continue;
+        }
+        if (pass == 0 && length - ifd - 2 - count * 12 >= 4)
+        {
+            ifds[2] = u32(ifd + 2 + count * 12);
+        }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            size_t entry = ifd + 2 + i * 12;
+            size_t value_offset = 0;
+            size_t value_count = 0;
+            if (!value_of(entry, value_offset, value_count))
+            {
+                continue;
+            }
+
+            switch (u16(entry))
+            {
+            case 0x8769:    // Exif IFD pointer
+                ifds[1] = pass == 0 ? number_of(entry) : ifds[1];
+                break;
+            case 0x0201:    // JPEGInterchangeFormat
+                thumbnail_offset = pass == 2 ? number_of(entry) : thumbnail_offset;
+                break;
+            case 0x0202:    // JPEGInterchangeFormatLength
+                thumbnail_length = pass == 2 ? number_of(entry) : thumbnail_length;
+                break;
+            case 0x0132:    // DateTime
+                date_offset = value_offset;
+                date_length = value_count;
+                break;
+            case 0x9003:    // DateTimeOriginal
+                original_offset = value_offset;
+                original_length = value_count;
+                break;
+            case 0x9011:    // OffsetTimeOriginal
+                zone_offset = value_offset;
+                zone_length = value_count;
+                break;
+            case 0xA002:    // PixelXDimension
+                pixel_width = number_of(entry);
+                break;
+            case 0xA003:    // PixelYDimension
+                pixel_height = number_of(entry);
+                break;
+            default:
+                break;
+            }
+        }
+    }
+
+    int64_t seconds = 0;
+    if ((original_length && parse_exif_time(tiff + original_offset, original_length, seconds)) ||
+        (date_length && parse_exif_time(tiff + date_offset, date_length, seconds)))
+    {
+        int64_t zone = 0;
+        if (zone_length && parse_exif_offset(tiff + zone_offset, zone_length, zone))
+        {
+            seconds -= zone;
+        }
+        metadata.capture_time = seconds;
+    }
+
+    // Container dimensions (JPEG frame, HEIF ispe) take precedence
+    if (metadata.width == 0 && pixel_width != 0 && pixel_height != 0)
+    {
+        metadata.width = pixel_width;
+        metadata.height = pixel_height;
+    }
+
+    if (thumbnail_length != 0 && thumbnail_offset <= length && thumbnail_length <= length - thumbnail_offset)
+    {
+        metadata.preview = media_preview();
+        metadata.preview.format = "jpeg";
+        metadata.preview.data_offset = position + thumbnail_offset;
+        metadata.preview.data_length = thumbnail_length;
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: parse_bmff                                                 */
+/*                                                                           */
+/* Description: Walks the top-level boxes of an ISO BMFF file. HEIF images   */
+/*              are read from the meta box, QuickTime and MP4 videos from    */
+/*              the moov box; media data is skipped by its size              */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void media_metadata_parser::parse_bmff(media_metadata& metadata)
+{
+    static const char* const heif_brands[] = {
+        "heic", "heix", "heim", "heis", "hevc", "hevx", "mif1", "msf1", "avif", "avis"
+    };
+
+    uint64_t end = bytes.size();
+    uint64_t position = 0;
+    bool heif = false;
+
+    box_info box;
+    while (read_box(position, end, box))
+    {
+        uint64_t content = box.start + box.header_size;
+        uint64_t box_end = box.start + box.size;
+
+        if (is_type(box.type, "ftyp"))
+        {
+            const char* brand = need(content, 4);
+            if (!brand)
+            {
+                return;
+            }
+            for (const char* heif_brand : heif_brands)
+            {
+                heif = heif || is_type(brand, heif_brand);
+            }
+        }
+        else if (is_type(box.type, "meta") && heif)
+        {
+            // Full box: skip version and flags
+            parse_heif_meta(content + 4, box_end, metadata);
+            return;
+        }
+        else if (is_type(box.type, "moov"))
+        {
+            parse_movie(content, box_end, metadata);
+            return;
+        }
+
+        position = box_end;
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: parse_heif_meta                                            */
+/*                                                                           */
+/* Description: Reads the primary item's dimensions from the item properties */
+/*              and locates the Exif item through the item information and   */
+/*              location boxes, then parses it. The thumbnail item named by  */
+/*              the item references is the preview when Exif has no JPEG one */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Locate the thumbnail item           */
+/*****************************************************************************/
+void media_metadata_parser::parse_heif_meta(uint64_t start, uint64_t end, media_metadata& metadata)
+{
+    struct item_extent {
+        uint64_t offset;
+        uint64_t length;
+        bool complete;      // The item is this one extent
+    };
+    struct item_property {
+        char type[4];
+        uint64_t offset;    // Of the property box contents
+        uint64_t length;
+        uint32_t width;     // ispe only
+        uint32_t height;
+    };
+
+    uint32_t primary_item = 0;
+    uint32_t thumbnail_item = 0;
+    bool have_thumbnail_item = false;
+    std::map<uint32_t, std::string> item_types;                     // Item ID -> item type
+    std::map<uint32_t, item_extent> extents;                        // Item ID -> first extent
+    std::vector<item_property> properties;                          // By property index - 1
+    std::map<uint32_t, std::vector<uint32_t> > associations;        // Item ID -> property indexes
+
+    uint64_t position = start;
+    box_info box;
+    while (read_box(position, end, box))
+    {
+        uint64_t content = box.start + box.header_size;
+        uint64_t box_end = box.start + box.size;
+        position = box_end;
+
+        if (is_type(box.type, "pitm"))
+        {
+            const char* pitm = need(content, 8);
+            if (!pitm)
+            {
+                return;
+            }
+            primary_item = pitm[0] == 0 ? get_be16(pitm + 4) : get_be32(pitm + 4);
+        }
+        else if (is_type(box.type, "iinf"))
+        {
+            const char* iinf = need(content, 4);
+            if (!iinf)
+            {
+                return;
+            }
+            uint64_t child = content + (iinf[0] == 0 ? 6 : 8);
+            box_info infe;
+            while (read_box(child, box_end, infe))
+            {
+                // Item info entries of version 2 and 3 carry the item type
+                const char* entry = need(infe.start + infe.header_size, 14);
+                if (entry && is_type(infe.type, "infe") && (entry[0] == 2 || entry[0] == 3))
+                {
+                    uint32_t item = entry[0] == 2 ? get_be16(entry + 4) : get_be32(entry + 4);
+                    item_types[item].assign(entry[0] == 2 ? entry + 8 : entry + 10, 4);
+                }
+                child = infe.start + infe.size;
+            }
+        }
+        else if (is_type(box.type, "iref"))
+        {
+            // Thumbnail references run from the thumbnail to the image it previews
+            const char* iref = need(content, box_end - content);
+            if (!iref || box_end - content < 4)
+            {
+                continue;
+            }
+            const char* limit = iref + (box_end - content);
+            size_t id_size = iref[0] == 0 ? 2 : 4;
+            const char* p = iref + 4;
+
+            while (limit - p >= 8)
+            {
+                uint32_t reference_size = get_be32(p);
+                if (reference_size < 8 + id_size + 2 || reference_size > static_cast<size_t>(limit - p))
+                {
+                    break;
+                }
+                if (is_type(p + 4, "thmb"))
+                {
+                    const char* q = p + 8;
+                    uint32_t from_item = id_size == 2 ? get_be16(q) : get_be32(q);
+                    uint32_t count = get_be16(q + id_size);
+                    q += id_size + 2;
+                    for (uint32_t i = 0; i < count && q + id_size <= p + reference_size; i++, q += id_size)
+                    {
+                        uint32_t to_item = id_size == 2 ? get_be16(q) : get_be32(q);
+                        if (!have_thumbnail_item || to_item == primary_item)
+                        {
+                            thumbnail_item = from_item;
+                            have_thumbnail_item = true;
+                        }
+                    }
+                }
+                p += reference_size;
+            }
+        }
+        else if (is_type(box.type, "iloc"))
+        {
+            const char* iloc = need(content, box_end - content);
+            if (!iloc)
+            {
+                return;
+            }
+            const char* limit = iloc + (box_end - content);
+            if (limit - iloc < 8)
+            {
+                continue;
+            }
+
+            unsigned version = static_cast<unsigned char>(iloc[0]);
+            unsigned offset_size = static_cast<unsigned char>(iloc[4]) >> 4;
+            unsigned length_size = static_cast<unsigned char>(iloc[4]) & 0x0F;
+            unsigned base_offset_size = static_cast<unsigned char>(iloc[5]) >> 4;
+            unsigned index_size = version >= 1 ? (static_cast<unsigned char>(iloc[5]) & 0x0F) : 0;
+            if (version > 2)
+            {
+                continue;
+            }
+
+            const char* p = iloc + 6;
+            uint32_t item_count = 0;
+            if (version < 2)
+            {
+                item_count = get_be16(p);
+                p += 2;
+            }
+            else
+            {
+                if (limit - p < 4)
+                {
+                    continue;
+                }
+                item_count = get_be32(p);
+                p += 4;
+            }
+
+            for (uint32_t i = 0; i < item_count; i++)
+            {
+                size_t fixed = (version < 2 ? 2 : 4) + (version >= 1 ? 2 : 0) + 2 + base_offset_size + 2;
+                if (static_cast<size_t>(limit - p) < fixed)
+                {
+                    break;
+                }
+
+                uint32_t item = version < 2 ? get_be16(p) : get_be32(p);
+                p += version < 2 ? 2 : 4;
+                unsigned construction = 0;
+                if (version >= 1)
+                {
+                    construction = get_be16(p) & 0x0F;
+                    p += 2;
+                }
+                p += 2;     // Data reference index
+                uint64_t base_offset = get_be_sized(p, base_offset_size);
+                p += base_offset_size;
+                uint32_t extent_count = get_be16(p);
+                p += 2;
+
+                size_t extent_size = index_size + offset_size + length_size;
+                if (static_cast<size_t>(limit - p) < extent_size * extent_count)
+                {
+                    break;
+                }
+                if (extent_count > 0 && construction == 0)
+                {
+                    item_extent extent;
+                    extent.offset = base_offset + get_be_sized(p + index_size, offset_size);
+                    extent.length = get_be_sized(p + index_size + offset_size, length_size);
+                    extent.complete = extent_count == 1;
+                    extents[item] = extent;
+                }
+                p += extent_size * extent_count;
+            }
+        }
+        else if (is_type(box.type, "iprp"))
+        {
+            uint64_t child = content;
+            box_info property_box;
+            while (read_box(child, box_end, property_box))
+            {
+                uint64_t property_content = property_box.start + property_box.header_size;
+                uint64_t property_end = property_box.start + property_box.size;
+
+                if (is_type(property_box.type, "ipco"))
+                {
+                    uint64_t next_property = property_content;
+                    box_info property_header;
+                    while (read_box(next_property, property_end, property_header))
+                    {
+                        item_property property;
+                        std::memcpy(property.type, property_header.type, 4);
+                        property.offset = property_header.start + property_header.header_size;
+                        property.length = property_header.size - property_header.header_size;
+                        property.width = 0;
+                        property.height = 0;
+                        if (is_type(property.type, "ispe"))
+                        {
+                            const char* ispe = need(property.offset, 12);
+                            if (ispe)
+                            {
+                                property.width = get_be32(ispe + 4);
+                                property.height = get_be32(ispe + 8);
+                            }
+                        }
+                        properties.push_back(property);
+                        next_property = property_header.start + property_header.size;
+                    }
+                }
+                else if (is_type(property_box.type, "ipma"))
+                {
+                    const char* ipma = need(property_content, property_end - property_content);
+                    if (ipma && property_end - property_content >= 8)
+                    {
+                        const char* limit = ipma + (property_end - property_content);
+                        unsigned version = static_cast<unsigned char>(ipma[0]);
+                        bool wide_index = (ipma[3] & 1) != 0;
+                        uint32_t entry_count = get_be32(ipma + 4);
+                        const char* p = ipma + 8;
+
+                        for (uint32_t i = 0; i < entry_count; i++)
+                        {
+                            size_t id_size = version < 1 ? 2 : 4;
+                            if (static_cast<size_t>(limit - p) < id_size + 1)
+                            {
+                                break;
+                            }
+                            uint32_t item = version < 1 ? get_be16(p) : get_be32(p);
+                            p += id_size;
+                            unsigned count = static_cast<unsigned char>(*p++);
+                            size_t index_bytes = wide_index ? 2 : 1;
+                            if (static_cast<size_t>(limit - p) < index_bytes * count)
+                            {
+                                break;
+                            }
+
+                            std::vector<uint32_t>& indexes = associations[item];
+                            for (unsigned j = 0; j < count; j++)
+                            {
+                                indexes.push_back(wide_index ? (get_be16(p) & 0x7FFF)
+                                                             : (static_cast<unsigned char>(*p) & 0x7F));
+                                p += index_bytes;
+                            }
+                        }
+                    }
+                }
+                child = property_end;
+            }
+        }
+    }
+
+    if (has_request)
+    {
+        return;
+    }
+
+    // Finds the property of the given type associated with an item
+    auto property_of = [&](uint32_t item, const char* type) -> const item_property* {
+        auto found = associations.find(item);
+        if (found == associations.end())
+        {
+            return nullptr;
+        }
+        for (uint32_t index : found->second)
+        {
+            if (index >= 1 && index <= properties.size() && is_type(properties[index - 1].type, type))
+            {
+                return &properties[index - 1];
+            }
+        }
+        return nullptr;
+    };
+
+    // Dimensions of the primary image, or of the largest one if unassociated
+    const item_property* primary_size = property_of(primary_item, "ispe");
+    if (primary_size && primary_size->width != 0)
+    {
+        metadata.width = primary_size->width;
+        metadata.height = primary_size->height;
+    }
+    else
+    {
+        for (const item_property& property : properties)
+        {
+            if (static_cast<uint64_t>(property.width) * property.height >
+                static_cast<uint64_t>(metadata.width) * metadata.height)
+            {
+                metadata.width = property.width;
+                metadata.height = property.height;
+            }
+        }
+    }
+
+    // The Exif item starts with the offset of the TIFF header within it
+    for (const auto& type : item_types)
+    {
+        auto exif = extents.find(type.first);
+        if (type.second != "Exif" || exif == extents.end() || exif->second.length <= 4)
+        {
+            continue;
+        }
+
+        const char* item = need(exif->second.offset, exif->second.length);
+        if (item)
+        {
+            uint64_t tiff_offset = 4 + static_cast<uint64_t>(get_be32(item));
+            if (tiff_offset < exif->second.length)
+            {
+                parse_exif(item + tiff_offset, static_cast<size_t>(exif->second.length - tiff_offset),
+                           exif->second.offset + tiff_offset, metadata);
+            }
+        }
+        break;
+    }
+
+    // A JPEG thumbnail from Exif is easier to use than an HEVC-coded item
+    auto thumbnail = have_thumbnail_item ? extents.find(thumbnail_item) : extents.end();
+    if (metadata.preview.format.empty() && thumbnail != extents.end() && thumbnail->second.complete &&
+        thumbnail->second.length <= max_request_size)
+    {
+        const std::string& type = item_types[thumbnail_item];
+        const item_property* config = property_of(thumbnail_item, "hvcC");
+        if (type == "jpeg" || (type == "hvc1" && config && config->length <= max_request_size))
+        {
+            metadata.preview.format = type;
+            metadata.preview.data_offset = thumbnail->second.offset;
+            metadata.preview.data_length = static_cast<uint32_t>(thumbnail->second.length);
+            if (type == "hvc1")
+            {
+                metadata.preview.config_offset = config->offset;
+                metadata.preview.config_length = static_cast<uint32_t>(config->length);
+            }
+        }
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: parse_movie                                                */
+/*                                                                           */
+/* Description: Reads the creation time and duration from the movie header,  */
+/*              and the frame size from the first visual track header.       */
+/*              Recurses into trak and mdia, skipping the sample tables      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void media_metadata_parser::parse_movie(uint64_t start, uint64_t end, media_metadata& metadata)
+{
+    uint64_t position = start;
+    box_info box;
+    while (read_box(position, end, box))
+    {
+        uint64_t content = box.start + box.header_size;
+        uint64_t box_end = box.start + box.size;
+        position = box_end;
+
+        if (is_type(box.type, "trak") || is_type(box.type, "mdia"))
+        {
+            parse_movie(content, box_end, metadata);
+        }
+        else if (is_type(box.type, "mvhd") || is_type(box.type, "mdhd"))
+        {
+            // Version 1 uses 64-bit times; both have the same layout otherwise
+            const char* header = need(content, 32);
+            if (!header)
+            {
+                continue;
+            }
+            bool version1 = header[0] == 1;
+            uint64_t created = version1 ? get_be64(header + 4) : get_be32(header + 4);
+            uint32_t timescale = get_be32(header + (version1 ? 20 : 12));
+            uint64_t duration = version1 ? get_be64(header + 24) : get_be32(header + 16);
+
+            // The movie header wins; a media header only fills gaps
+            bool movie_header = is_type(box.type, "mvhd");
+            if (created > quicktime_epoch_offset && (movie_header || metadata.capture_time == 0))
+            {
+                metadata.capture_time = static_cast<int64_t>(created - quicktime_epoch_offset);
+            }
+            if (timescale != 0 && (movie_header || metadata.duration_seconds == 0.0))
+            {
+                metadata.duration_seconds = static_cast<double>(duration) / timescale;
+            }
+        }
+        else if (is_type(box.type, "tkhd") && metadata.width == 0)
+        {
+            // Matrix then 16.16 fixed-point width and height at the end
+            const char* version = need(content, 1);
+            if (!version)
+            {
+                continue;
+            }
+            size_t size_offset = version[0] == 1 ? 88 : 76;
+            const char* header = need(content, size_offset + 8);
+            if (!header)
+            {
+                continue;
+            }
+
+            uint32_t width = get_be32(header + size_offset) >> 16;
+            uint32_t height = get_be32(header + size_offset + 4) >> 16;
+
+            // A quarter-turn matrix (a = 0, b != 0) means the video is shown rotated
+            bool rotated = get_be32(header + size_offset - 36) == 0 &&
+                           get_be32(header + size_offset - 32) != 0;
+            if (width != 0 && height != 0)
+            {
+                metadata.width = rotated ? height : width;
+                metadata.height = rotated ? width : height;
+            }
+        }
+    }
+}
@@ -0,0 +1,384 @@
+#include "media_store.h"
+#include "local_fs.h"
+#include <iostream>
+#include <fstream>
+#include <cstdlib>
+
+// Store layout below the root directory, and the index file headers
+static const char* const objects_directory = "objects";
+static const char* const devices_directory = "devices";
+static const char* const temp_directory = "tmp";
+static const char* const probe_index_name = "probes";
+static const char* const manifest_suffix = ".manifest";
+static const char* const probe_index_header = "mediastore probes 1";
+static const char* const manifest_header = "mediastore manifest 1";
+
+/*****************************************************************************/
+/* Function Name: write_replace                                              */
+/*                                                                           */
+/* Description: Writes text to a file through a temporary file, so an        */
+/*              interrupted run leaves the previous version intact           */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static bool write_replace(const std::string& path, const std::string& contents)
+{
+    std::string temp_path = path + ".tmp";
+    {
+        std::ofstream outfile(temp_path, std::ios::binary | std::ios::trunc);
+        if (!outfile.is_open())
+        {
+            return false;
+        }
+
+        outfile.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        if (!outfile.good())
+        {
+            return false;
+        }
+    }
+
+    return local_fs::rename_replace(temp_path, path);
+}
+
+/*****************************************************************************/
+/* Function Name: media_store (Constructor)                                  */
+/*                                                                           */
+/* Description: Creates a store rooted at root_path; call open before use    */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+media_store::media_store(const std::string& root_path)
+    : root(root_path), probes_modified(false)
+{
+}
+
+/*****************************************************************************/
+/* Function Name: open                                                       */
+/*                                                                           */
+/* Description: Creates the store directories and loads the probe index.     */
+/*              Each index line holds the file size, probe hash and content  */
+/*              hash, separated by tabs                                      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool media_store::open()
+{
+    const char* directories[] = { objects_directory, devices_directory, temp_directory };
+    for (const char* name : directories)
+    {
+        std::string path = local_fs::join_path(root, name);
+        if (!local_fs::make_directories(path))
+        {
+            std::cerr << "Error: Failed to create store directory: " << path << std::endl;
+            return false;
+        }
+    }
+
+    probes.clear();
+    probes_modified = false;
+
+    std::ifstream infile(local_fs::join_path(root, probe_index_name));
+    std::string line;
+    if (!infile.is_open() || !std::getline(infile, line) || line != probe_index_header)
+    {
+        return true;
+    }
+
+    while (std::getline(infile, line))
+    {
+        size_t first_tab = line.find('\t');
+        size_t second_tab = (first_tab == std::string::npos) ? first_tab : line.find('\t', first_tab + 1);
+        if (second_tab == std::string::npos)
+        {
+            continue;
+        }
+
+        std::string key = line.substr(0, first_tab) + ":" + line.substr(first_tab + 1, second_tab - first_tab - 1);
+        probes[key] = line.substr(second_tab + 1);
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: save                                                       */
+/*                                                                           */
+/* Description: Writes the probe index if it gained entries                  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool media_store::save()
+{
+    if (!probes_modified)
+    {
+        return true;
+    }
+
+    std::string contents = std::string(probe_index_header) + "\n";
+    for (const auto& item : probes)
+    {
+        size_t colon = item.first.find(':');
+        contents += item.first.substr(0, colon) + "\t" + item.first.substr(colon + 1) + "\t" + item.second + "\n";
+    }
+
+    std::string path = local_fs::join_path(root, probe_index_name);
+    if (!write_replace(path, contents))
+    {
+        std::cerr << "Error: Failed to write store index: " << path << std::endl;
+        return false;
+    }
+
+    probes_modified = false;
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: find_probe                                                 */
+/*                                                                           */
+/* Description: Returns the content hash recorded for a file size and probe  */
+/*              hash whose object is still present, or an empty string       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+std::string media_store::find_probe(uint64_t file_size, const std::string& probe_hash) const
+{
+    auto it = probes.find(std::to_string(file_size) + ":" + probe_hash);
+    if (it == probes.end() || !has_object(it->second))
+    {
+        return std::string();
+    }
+    return it->second;
+}
+
+/*****************************************************************************/
+/* Function Name: record_probe                                               */
+/*                                                                           */
+/* Description: Remembers which content a file size and probe hash lead to   */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void media_store::record_probe(uint64_t file_size, const std::string& probe_hash, const std::string& content_hash)
+{
+    std::string& known = probes[std::to_string(file_size) + ":" + probe_hash];
+    if (known != content_hash)
+    {
+        known = content_hash;
+        probes_modified = true;
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: object_path                                                */
+/*                                                                           */
+/* Description: Returns where an object lives, fanned out over 256           */
+/*              subdirectories by the first two hex digits of its hash       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+std::string media_store::object_path(const std::string& content_hash) const
+{
+    std::string fan_out = local_fs::join_path(local_fs::join_path(root, objects_directory), content_hash.substr(0, 2));
+    return local_fs::join_path(fan_out, content_hash);
+}
+
+/*****************************************************************************/
+/* Function Name: has_object                                                 */
+/*                                                                           */
+/* Description: Checks whether the store holds the given content             */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool media_store::has_object(const std::string& content_hash) const
+{
+    return !content_hash.empty() && local_fs::stat_path(object_path(content_hash)).exists;
+}
+
+/*****************************************************************************/
+/* Function Name: add_file                                                   */
+/*                                                                           */
+/* Description: Moves a finished download into the store under its content   */
+/*              hash. If the content is already stored the file is dropped   */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool media_store::add_file(const std::string& path, const std::string& content_hash)
+{
+    if (has_object(content_hash))
+    {
+        local_fs::remove_file(path);
+        return true;
+    }
+
+    std::string target = object_path(content_hash);
+    if (!local_fs::make_directories(local_fs::parent_path(target)) || !local_fs::rename_replace(path, target))
+    {
+        std::cerr << "Error: Failed to add " << path << " to the store." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: add_data                                                   */
+/*                                                                           */
+/* Description: Stores contents already held in memory under their hash      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool media_store::add_data(const char* data, size_t length, const std::string& content_hash)
+{
+    if (has_object(content_hash))
+    {
+        return true;
+    }
+
+    std::string target = object_path(content_hash);
+    if (!local_fs::make_directories(local_fs::parent_path(target)) ||
+        !write_replace(target, std::string(data, length)))
+    {
+        std::cerr << "Error: Failed to write store object: " << target << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: device_root                                                */
+/*                                                                           */
+/* Description: Returns the directory holding a device's tree of links       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+std::string media_store::device_root(const std::string& device_id) const
+{
+    return local_fs::join_path(local_fs::join_path(root, devices_directory), device_id);
+}
+
+/*****************************************************************************/
+/* Function Name: temp_path                                                  */
+/*                                                                           */
+/* Description: Returns a path in the store's scratch directory. It sits on  */
+/*              the same volume as the objects, so adding is a rename        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+std::string media_store::temp_path(const std::string& name) const
+{
+    return local_fs::join_path(local_fs::join_path(root, temp_directory), name);
+}
+
+/*****************************************************************************/
+/* Function Name: link_into                                                  */
+/*                                                                           */
+/* Description: Makes tree_path a hard link to a stored object, replacing    */
+/*              whatever was there. Fails where hard links are not           */
+/*              supported; the device manifest still records the file        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool media_store::link_into(const std::string& content_hash, const std::string& tree_path)
+{
+    if (!local_fs::make_directories(local_fs::parent_path(tree_path)))
+    {
+        return false;
+    }
+
+    local_fs::remove_file(tree_path);
+    return local_fs::make_hard_link(object_path(content_hash), tree_path);
+}
+
+/*****************************************************************************/
+/* Function Name: load_manifest                                              */
+/*                                                                           */
+/* Description: Reads a device manifest. Each line holds the content hash,   */
+/*              size, remote mtime and relative path, separated by tabs. A   */
+/*              missing manifest yields an empty one                         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+store_manifest media_store::load_manifest(const std::string& device_id) const
+{
+    store_manifest manifest;
+
+    std::ifstream infile(device_root(device_id) + manifest_suffix);
+    std::string line;
+    if (!infile.is_open() || !std::getline(infile, line) || line != manifest_header)
+    {
+        return manifest;
+    }
+
+    while (std::getline(infile, line))
+    {
+        size_t first_tab = line.find('\t');
+        size_t second_tab = (first_tab == std::string::npos) ? first_tab : line.find('\t', first_tab + 1);
+        size_t third_tab = (second_tab == std::string::npos) ? second_tab : line.find('\t', second_tab + 1);
+        if (third_tab == std::string::npos)
+        {
+            continue;
+        }
+
+        store_entry entry;
+        entry.content_hash = line.substr(0, first_tab);
+        entry.file_size = strtoull(line.c_str() + first_tab + 1, nullptr, 10);
+        entry.modified_time = strtoull(line.c_str() + second_tab + 1, nullptr, 10);
+        manifest[line.substr(third_tab + 1)] = entry;
+    }
+
+    return manifest;
+}
+
+/*****************************************************************************/
+/* Function Name: save_manifest                                              */
+/*                                                                           */
+/* Description: Writes a device manifest next to the device tree             */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool media_store::save_manifest(const std::string& device_id, const store_manifest& manifest) const
+{
+    std::string contents = std::string(manifest_header) + "\n";
+    for (const auto& item : manifest)
+    {
+        contents += item.second.content_hash + "\t" + std::to_string(item.second.file_size) + "\t" +
+                    std::to_string(item.second.modified_time) + "\t" + item.first + "\n";
+    }
+
+    std::string path = device_root(device_id) + manifest_suffix;
+    if (!write_replace(path, contents))
+    {
+        std::cerr << "Error: Failed to write device manifest: " << path << std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,484 @@
+#include "photo_catalog.h"
+#include "local_fs.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+// File layout, all integers little-endian and every record 8-byte aligned:
+//   header     magic[8], u32 directory_count, u32 entry_count, u64 string_bytes
+//   directory  u64 mtime, u32 path_offset, u32 path_length, u32 first_entry, u32 entry_count
+//   entry      u64 size, u64 mtime, u32 name_offset, u32 name_length, u8 type, u8 padding[7]
+//   strings    directory paths and entry names, not terminated
+static const char catalog_magic[8] = { 'I', 'D', 'V', 'C', 'A', 'T', '0', '1' };
+static const size_t header_size = 24;
+static const size_t directory_record_size = 24;
+static const size_t entry_record_size = 32;
+
+// Read-only view of a memory-mapped file
+struct mapped_view {
+    const char* data = nullptr;
+    size_t length = 0;
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+#endif
+};
+
+/*****************************************************************************/
+/* Function Name: get_u32                                                    */
+/*                                                                           */
+/* Description: Decodes a little-endian 32-bit value                         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static uint32_t get_u32(const char* p)
+{
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint32_t>(b[0]) | (static_cast<uint32_t>(b[1]) << 8) |
+           (static_cast<uint32_t>(b[2]) << 16) | (static_cast<uint32_t>(b[3]) << 24);
+}
+
+/*****************************************************************************/
+/* Function Name: get_u64                                                    */
+/*                                                                           */
+/* Description: Decodes a little-endian 64-bit value                         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static uint64_t get_u64(const char* p)
+{
+    return static_cast<uint64_t>(get_u32(p)) | (static_cast<uint64_t>(get_u32(p + 4)) << 32);
+}
+
+/*****************************************************************************/
+/* Function Name: put_u32                                                    */
+/*                                                                           */
+/* Description: Appends a little-endian 32-bit value                         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static void put_u32(std::string& out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: put_u64                                                    */
+/*                                                                           */
+/* Description: Appends a little-endian 64-bit value                         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static void put_u64(std::string& out, uint64_t value)
+{
+    put_u32(out, static_cast<uint32_t>(value & 0xffffffffu));
+    put_u32(out, static_cast<uint32_t>(value >> 32));
+}
+
+/*****************************************************************************/
+/* Function Name: map_file                                                   */
+/*                                                                           */
+/* Description: Maps a whole file read-only. Empty files cannot be mapped    */
+/*              and are reported as failures                                 */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static bool map_file(const std::string& path, mapped_view& view)
+{
+#ifdef _WIN32
+    view.file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, NULL);
+    if (view.file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(view.file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(view.file);
+        return false;
+    }
+
+    view.mapping = CreateFileMappingA(view.file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!view.mapping)
+    {
+        CloseHandle(view.file);
+        return false;
+    }
+
+    view.data = static_cast<const char*>(MapViewOfFile(view.mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!view.data)
+    {
+        CloseHandle(view.mapping);
+        CloseHandle(view.file);
+        return false;
+    }
+    view.length = static_cast<size_t>(size.QuadPart);
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    view.data = static_cast<const char*>(data);
+    view.length = static_cast<size_t>(st.st_size);
+#endif
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: unmap_file                                                 */
+/*                                                                           */
+/* Description: Releases a view created by map_file                          */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static void unmap_file(mapped_view& view)
+{
+#ifdef _WIN32
+    UnmapViewOfFile(view.data);
+    CloseHandle(view.mapping);
+    CloseHandle(view.file);
+#else
+    munmap(const_cast<char*>(view.data), view.length);
+#endif
+    view.data = nullptr;
+    view.length = 0;
+}
+
+/*****************************************************************************/
+/* Function Name: parse_catalog                                              */
+/*                                                                           */
+/* Description: Decodes a mapped catalog into directory listings. Every      */
+/*              offset and count is checked against the file size, so a      */
+/*              truncated or foreign file is rejected rather than trusted    */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Reject sizes that wrap around       */
+/*****************************************************************************/
+static bool parse_catalog(const char* data, size_t length, std::map<std::string, catalog_directory>& directories)
+{
+    if (length < header_size || memcmp(data, catalog_magic, sizeof(catalog_magic)) != 0)
+    {
+        return false;
+    }
+
+    uint64_t directory_count = get_u32(data + 8);
+    uint64_t entry_count = get_u32(data + 12);
+    uint64_t string_bytes = get_u64(data + 16);
+
+    uint64_t directories_start = header_size;
+    uint64_t entries_start = directories_start + directory_count * directory_record_size;
+    uint64_t strings_start = entries_start + entry_count * entry_record_size;
+    // The counts are 32-bit, so only string_bytes can push a sum past 64 bits
+    if (strings_start > length || string_bytes != length - strings_start)
+    {
+        return false;
+    }
+
+    const char* strings = data + strings_start;
+    directories.clear();
+
+    for (uint64_t d = 0; d < directory_count; d++)
+    {
+        const char* record = data + directories_start + d * directory_record_size;
+        uint64_t path_offset = get_u32(record + 8);
+        uint64_t path_length = get_u32(record + 12);
+        uint64_t first_entry = get_u32(record + 16);
+        uint64_t count = get_u32(record + 20);
+
+        if (path_offset + path_length > string_bytes || first_entry + count > entry_count)
+        {
+            return false;
+        }
+
+        std::string path(strings + path_offset, path_length);
+        std::string prefix = (!path.empty() && path[path.size() - 1] == '/') ? path : path + "/";
+
+        catalog_directory& directory = directories[path];
+        directory.modified_time = get_u64(record);
+        directory.entries.resize(count);
+
+        for (uint64_t e = 0; e < count; e++)
+        {
+            const char* entry = data + entries_start + (first_entry + e) * entry_record_size;
+            uint64_t name_offset = get_u32(entry + 16);
+            uint64_t name_length = get_u32(entry + 20);
+            if (name_offset + name_length > string_bytes)
+            {
+                return false;
+            }
+
+            file_info& info = directory.entries[e];
+            info.filename.assign(strings + name_offset, name_length);
+            info.full_path = prefix + info.filename;
+            info.file_size = get_u64(entry);
+            info.modified_time = get_u64(entry + 8);
+            info.file_type = static_cast<afc_file_type>(static_cast<unsigned char>(entry[24]));
+        }
+    }
+
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: photo_catalog (Constructor)                                */
+/*                                                                           */
+/* Description: Creates an empty catalog backed by the given file            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+photo_catalog::photo_catalog(const std::string& path)
+    : catalog_path(path), modified(false)
+{
+}
+
+/*****************************************************************************/
+/* Function Name: load                                                       */
+/*                                                                           */
+/* Description: Reads the catalog file. A missing or unreadable file leaves  */
+/*              the catalog empty, so the next refresh lists everything      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool photo_catalog::load()
+{
+    directories.clear();
+    modified = false;
+
+    mapped_view view;
+    if (!map_file(catalog_path, view))
+    {
+        return false;
+    }
+
+    bool parsed = parse_catalog(view.data, view.length, directories);
+    unmap_file(view);
+
+    if (!parsed)
+    {
+        std::cerr << "Warning: Ignoring damaged photo catalog: " << catalog_path << std::endl;
+        directories.clear();
+        modified = true;
+    }
+
+    return parsed;
+}
+
+/*****************************************************************************/
+/* Function Name: save                                                       */
+/*                                                                           */
+/* Description: Writes the catalog if it changed since it was loaded. The    */
+/*              new file replaces the old one only once fully written        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool photo_catalog::save()
+{
+    if (!modified)
+    {
+        return true;
+    }
+
+    std::string directory_records;
+    std::string entry_records;
+    std::string strings;
+    uint32_t entry_total = 0;
+
+    for (const auto& item : directories)
+    {
+        put_u64(directory_records, item.second.modified_time);
+        put_u32(directory_records, static_cast<uint32_t>(strings.size()));
+        put_u32(directory_records, static_cast<uint32_t>(item.first.size()));
+        put_u32(directory_records, entry_total);
+        put_u32(directory_records, static_cast<uint32_t>(item.second.entries.size()));
+        strings += item.first;
+
+        for (const file_info& info : item.second.entries)
+        {
+            put_u64(entry_records, info.file_size);
+            put_u64(entry_records, info.modified_time);
+            put_u32(entry_records, static_cast<uint32_t>(strings.size()));
+            put_u32(entry_records, static_cast<uint32_t>(info.filename.size()));
+            entry_records.push_back(static_cast<char>(info.file_type));
+            entry_records.append(7, '\0');
+            strings += info.filename;
+        }
+        entry_total += static_cast<uint32_t>(item.second.entries.size());
+    }
+
+    std::string header(catalog_magic, sizeof(catalog_magic));
+    put_u32(header, static_cast<uint32_t>(directories.size()));
+    put_u32(header, entry_total);
+    put_u64(header, strings.size());
+
+    local_fs::make_directories(local_fs::parent_path(catalog_path));
+    std::string temp_path = catalog_path + ".tmp";
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    out << header << directory_records << entry_records << strings;
+    out.close();
+
+    if (out.fail() || !local_fs::rename_replace(temp_path, catalog_path))
+    {
+        std::cerr << "Error: Failed to write photo catalog: " << catalog_path << std::endl;
+        local_fs::remove_file(temp_path);
+        return false;
+    }
+
+    modified = false;
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: find                                                       */
+/*                                                                           */
+/* Description: Returns the recorded listing of a directory, or nullptr      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+const catalog_directory* photo_catalog::find(const std::string& directory) const
+{
+    auto it = directories.find(directory);
+    return (it != directories.end()) ? &it->second : nullptr;
+}
+
+/*****************************************************************************/
+/* Function Name: store                                                      */
+/*                                                                           */
+/* Description: Records a fresh listing of a directory and its mtime         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void photo_catalog::store(const std::string& directory, uint64_t modified_time,
+                          const std::vector<file_info>& entries)
+{
+    catalog_directory& record = directories[directory];
+    record.modified_time = modified_time;
+    record.entries = entries;
+    modified = true;
+}
+
+/*****************************************************************************/
+/* Function Name: retain                                                     */
+/*                                                                           */
+/* Description: Drops the directories that a refresh no longer found         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void photo_catalog::retain(const std::set<std::string>& directories_seen)
+{
+    for (auto it = directories.begin(); it != directories.end(); )
+    {
+        if (directories_seen.count(it->first) == 0)
+        {
+            it = directories.erase(it);
+            modified = true;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: all_directories                                            */
+/*                                                                           */
+/* Description: Returns every recorded directory listing, keyed by path      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+const std::map<std::string, catalog_directory>& photo_catalog::all_directories() const
+{
+    return directories;
+}
+
+/*****************************************************************************/
+/* Function Name: entry_count                                                */
+/*                                                                           */
+/* Description: Returns the number of entries across all directories         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+size_t photo_catalog::entry_count() const
+{
+    size_t total = 0;
+    for (const auto& item : directories)
+    {
+        total += item.second.entries.size();
+    }
+    return total;
+}
+
+/*****************************************************************************/
+/* Function Name: path                                                       */
+/*                                                                           */
+/* Description: Returns the file the catalog is stored in                    */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+const std::string& photo_catalog::path() const
+{
+    return catalog_path;
+}
@@ -1,6 +1,195 @@
 #include "photo_manager.h"
+#include "local_fs.h"
+#include "content_hasher.h"
 #include <iostream>
 #include <algorithm>
+#include <ctime>
+#include <cstdlib>
+#include <chrono>
+#include <map>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+// Media root on the device and the catalog file name suffix
+static const char* const media_root = "/DCIM";
+static const char* const catalog_suffix = ".catalog";
+
+// Backups download next to the final name and rename into place. FAT and
+// exFAT store mtimes in 2 second steps, hence the comparison tolerance
+static const char* const backup_temp_suffix = ".partial";
+static const int64_t backup_mtime_tolerance = 2;
+
+// Bytes read from each end of a file to recognise it in the media store.
+// Files up to twice this size are read whole by the probe
+static const uint32_t store_probe_size = 64 * 1024;
+
+// Metadata is read in rounds over batches of files: first the head of every
+// file, then whatever box or segment each parser asks for next. Batching
+// bounds the memory held for fetched header bytes
+static const uint32_t metadata_head_size = 32 * 1024;
+static const size_t metadata_batch_size = 256;
+static const int metadata_max_rounds = 8;
+
+// Photos for_each_photo lets the walk run ahead of its visitor
+static const size_t photo_queue_capacity = 256;
+
+// A file of an asset still to be downloaded. The files of one asset
+// download to temporary names and are moved into place together, only once
+// every one of them has arrived
+struct pending_file {
+    std::string source_path;
+    std::string final_path;
+    int64_t modified_seconds;   // Remote mtime given to the local file
+};
+typedef std::vector<pending_file> pending_group;
+
+/*****************************************************************************/
+/* Function Name: default_catalog_directory                                  */
+/*                                                                           */
+/* Description: Returns the per-user directory catalogs are kept in:         */
+/*              %LOCALAPPDATA%\IDevTool on Windows, ~/.idevtool elsewhere    */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static std::string default_catalog_directory()
+{
+#ifdef _WIN32
+    const char* base = getenv("LOCALAPPDATA");
+    return local_fs::join_path(base ? base : ".", "IDevTool");
+#else
+    const char* base = getenv("HOME");
+    return local_fs::join_path(base ? base : ".", ".idevtool");
+#endif
+}
+
+/*****************************************************************************/
+/* Function Name: file_stem                                                  */
+/*                                                                           */
+/* Description: Returns a filename without its extension                     */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static std::string file_stem(const std::string& filename)
+{
+    size_t dot = filename.find_last_of('.');
+    return (dot == std::string::npos) ? filename : filename.substr(0, dot);
+}
+
+/*****************************************************************************/
+/* Function Name: asset_base_name                                            */
+/*                                                                           */
+/* Description: Returns the name shared by the files of one asset. Edited    */
+/*              renders and adjustment files insert E (or O) after the       */
+/*              prefix, so IMG_E1234.AAE belongs with IMG_1234.HEIC          */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static std::string asset_base_name(const std::string& filename)
+{
+    std::string stem = file_stem(filename);
+    if (stem.size() > 5 && stem.compare(0, 4, "IMG_") == 0 && (stem[4] == 'E' || stem[4] == 'O') &&
+        stem[5] >= '0' && stem[5] <= '9')
+    {
+        stem.erase(4, 1);
+    }
+    return stem;
+}
+
+/*****************************************************************************/
+/* Function Name: download_groups                                            */
+/*                                                                           */
+/* Description: Downloads the files of several assets in one parallel batch. */
+/*              The files of an asset are queued next to each other, so the  */
+/*              pool works on them together. An asset's files are renamed    */
+/*              into place only when all of them completed; otherwise the    */
+/*              finished ones are removed, leaving the asset absent rather   */
+/*              than half there. Failed downloads keep their temporary file  */
+/*              and journal to resume from. Updates totals and returns the   */
+/*              number of assets that could not be completed                 */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Handle a batch that never started   */
+/*****************************************************************************/
+static size_t download_groups(afc_manager* afc, const std::vector<pending_group>& groups, mirror_stats& totals)
+{
+    std::vector<transfer_request> requests;
+    for (const pending_group& group : groups)
+    {
+        for (const pending_file& file : group)
+        {
+            transfer_request request;
+            request.source_path = file.source_path;
+            request.destination_path = file.final_path + backup_temp_suffix;
+            requests.push_back(request);
+        }
+    }
+
+    std::vector<transfer_stats> results;
+    if (!requests.empty())
+    {
+        afc->download_files(requests, &results);
+    }
+
+    // download_files gives up before filling results when the connection is
+    // down; every request then counts as not completed
+    if (results.size() != requests.size())
+    {
+        results.assign(requests.size(), transfer_stats());
+    }
+
+    size_t failed_groups = 0;
+    size_t next = 0;
+    for (const pending_group& group : groups)
+    {
+        size_t first = next;
+        next += group.size();
+
+        bool complete = true;
+        for (size_t i = first; i < next; i++)
+        {
+            complete = complete && results[i].completed;
+        }
+
+        if (!complete)
+        {
+            failed_groups++;
+            for (size_t i = first; i < next; i++)
+            {
+                if (results[i].completed)
+                {
+                    local_fs::remove_file(requests[i].destination_path);
+                }
+                totals.files_failed++;
+            }
+            continue;
+        }
+
+        for (size_t i = first; i < next; i++)
+        {
+            local_fs::set_modified_time(requests[i].destination_path, group[i - first].modified_seconds);
+            if (!local_fs::rename_replace(requests[i].destination_path, group[i - first].final_path))
+            {
+                std::cerr << "Error: Failed to move " << requests[i].destination_path << " into place." << std::endl;
+                totals.files_failed++;
+                continue;
+            }
+            totals.files_transferred++;
+            totals.bytes_transferred += results[i].bytes_transferred;
+        }
+    }
+
+    return failed_groups;
+}
 
 /*****************************************************************************/
 /* Function Name: photo_manager (Constructor)                                */
@@ -12,7 +201,7 @@
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
 /*****************************************************************************/
 photo_manager::photo_manager()
-    : afc(new afc_manager()), owns_afc(true)
+    : afc(new afc_manager()), owns_afc(true), catalog(nullptr)
 {
 }
 
@@ -26,7 +215,7 @@ photo_manager::photo_manager()
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
 /*****************************************************************************/
 photo_manager::photo_manager(afc_manager* existing_afc)
-    : afc(existing_afc), owns_afc(false)
+    : afc(existing_afc), owns_afc(false), catalog(nullptr)
 {
 }
 
@@ -38,9 +227,12 @@ photo_manager::photo_manager(afc_manager* existing_afc)
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Release the photo catalog           */
 /*****************************************************************************/
 photo_manager::~photo_manager()
 {
+    delete catalog;
+
     if (owns_afc && afc)
     {
         delete afc;
@@ -84,6 +276,151 @@ void photo_manager::disconnect()
     }
 }
 
+/*****************************************************************************/
+/* Function Name: open_catalog                                               */
+/*                                                                           */
+/* Description: Enables the persistent catalog for the device with the       */
+/*              given UDID, stored in directory or the per-user default.     */
+/*              Listings and counts are then served from the catalog, and    */
+/*              only directories whose mtime changed are listed again        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool photo_manager::open_catalog(const std::string& device_id, const std::string& directory)
+{
+    if (device_id.empty())
+    {
+        std::cerr << "Error: A device UDID is required for the photo catalog." << std::endl;
+        return false;
+    }
+
+    std::string base = directory.empty() ? default_catalog_directory() : directory;
+    if (!local_fs::make_directories(base))
+    {
+        std::cerr << "Error: Failed to create catalog directory: " << base << std::endl;
+        return false;
+    }
+
+    delete catalog;
+    catalog = new photo_catalog(local_fs::join_path(base, device_id + catalog_suffix));
+    catalog->load();
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: extension_key                                              */
+/*                                                                           */
+/* Description: Packs a lowercase extension of up to 8 characters into an    */
+/*              integer, so the media table below is a switch over           */
+/*              compile-time constants                                       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static constexpr uint64_t extension_key(const char* ext, uint64_t key = 0)
+{
+    return *ext ? extension_key(ext + 1, (key << 8) | static_cast<unsigned char>(*ext)) : key;
+}
+
+/*****************************************************************************/
+/* Function Name: filename_extension_key                                     */
+/*                                                                           */
+/* Description: Returns the extension_key of a filename's extension, ASCII   */
+/*              letters folded to lowercase, without copying the name. Names */
+/*              with no extension or one longer than 8 characters give 0     */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static uint64_t filename_extension_key(const std::string& filename)
+{
+    size_t dot_pos = filename.find_last_of('.');
+    if (dot_pos == std::string::npos || filename.size() - dot_pos - 1 > 8)
+    {
+        return 0;
+    }
+
+    uint64_t key = 0;
+    for (size_t i = dot_pos + 1; i < filename.size(); i++)
+    {
+        unsigned char c = static_cast<unsigned char>(filename[i]);
+        if (c >= 'A' && c <= 'Z')
+        {
+            c = static_cast<unsigned char>(c | 0x20);
+        }
+        key = (key << 8) | c;
+    }
+    return key;
+}
+
+/*****************************************************************************/
+/* Function Name: classify_media                                             */
+/*                                                                           */
+/* Description: Decides from its extension whether a file is a photo, a      */
+/*              video or an edit/metadata sidecar. Runs for every scanned    */
+/*              entry, so it neither allocates nor lowercases a copy         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Compile-time extension table        */
+/*****************************************************************************/
+media_kind photo_manager::classify_media(const std::string& filename)
+{
+    switch (filename_extension_key(filename))
+    {
+        // Still images, including ProRAW (DNG) and imported camera raw files
+        case extension_key("jpg"):
+        case extension_key("jpeg"):
+        case extension_key("jpe"):
+        case extension_key("png"):
+        case extension_key("heic"):
+        case extension_key("heif"):
+        case extension_key("heics"):
+        case extension_key("hif"):
+        case extension_key("avif"):
+        case extension_key("webp"):
+        case extension_key("gif"):
+        case extension_key("bmp"):
+        case extension_key("tiff"):
+        case extension_key("tif"):
+        case extension_key("dng"):
+        case extension_key("cr2"):
+        case extension_key("cr3"):
+        case extension_key("nef"):
+        case extension_key("arw"):
+        case extension_key("raf"):
+        case extension_key("orf"):
+        case extension_key("rw2"):
+            return media_kind::photo;
+
+        // Video, including HEVC and ProRes in QuickTime or MPEG-4 containers
+        case extension_key("mov"):
+        case extension_key("qt"):
+        case extension_key("mp4"):
+        case extension_key("m4v"):
+        case extension_key("hevc"):
+        case extension_key("3gp"):
+        case extension_key("avi"):
+        case extension_key("mkv"):
+        case extension_key("mts"):
+        case extension_key("m2ts"):
+            return media_kind::video;
+
+        // Photos edit recipes and XMP metadata
+        case extension_key("aae"):
+        case extension_key("xmp"):
+            return media_kind::sidecar;
+
+        default:
+            return media_kind::other;
+    }
+}
+
 /*****************************************************************************/
 /* Function Name: is_photo_file                                              */
 /*                                                                           */
@@ -92,15 +429,11 @@ void photo_manager::disconnect()
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Delegate to classify_media          */
 /*****************************************************************************/
 bool photo_manager::is_photo_file(const std::string& filename)
 {
-    std::string ext = get_file_extension(filename);
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-
-    return (ext == "jpg" || ext == "jpeg" || ext == "png" ||
-            ext == "heic" || ext == "heif" || ext == "gif" ||
-            ext == "bmp" || ext == "tiff" || ext == "tif");
+    return classify_media(filename) == media_kind::photo;
 }
 
 /*****************************************************************************/
@@ -111,14 +444,11 @@ bool photo_manager::is_photo_file(const std::string& filename)
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Delegate to classify_media          */
 /*****************************************************************************/
 bool photo_manager::is_video_file(const std::string& filename)
 {
-    std::string ext = get_file_extension(filename);
-    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
-
-    return (ext == "mov" || ext == "mp4" || ext == "m4v" ||
-            ext == "avi" || ext == "mkv");
+    return classify_media(filename) == media_kind::video;
 }
 
 /*****************************************************************************/
@@ -141,44 +471,34 @@ std::string photo_manager::get_file_extension(const std::string& filename)
 }
 
 /*****************************************************************************/
-/* Function Name: scan_for_photos                                            */
+/* Function Name: add_to_scan                                                */
 /*                                                                           */
-/* Description: Recursively scans a directory for photo files                */
+/* Description: Classifies one file and adds it to the matching listing and  */
+/*              totals of a scan                                             */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
-/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
 /*****************************************************************************/
-void photo_manager::scan_for_photos(const std::string& path, std::vector<photo_info>& photos)
+void photo_manager::add_to_scan(const file_info& finfo, media_scan& scan)
 {
-    if (!afc || !afc->is_connected())
-    {
-        return;
-    }
-
-    std::vector<std::string> entries = afc->list_directory(path);
-
-    for (const auto& entry : entries)
+    switch (classify_media(finfo.filename))
     {
-        std::string full_path = path;
-        if (full_path.back() != '/')
-        {
-            full_path += "/";
-        }
-        full_path += entry;
-
-        file_info finfo = afc->get_file_info(full_path);
-
-        if (finfo.is_directory)
-        {
-            // Recursively scan subdirectories
-            scan_for_photos(full_path, photos);
-        }
-        else if (is_photo_file(entry))
-        {
-            // Add photo to list
-            photos.push_back(file_info_to_photo_info(finfo));
-        }
+        case media_kind::photo:
+            scan.photos.push_back(file_info_to_photo_info(finfo));
+            scan.photo_bytes += finfo.file_size;
+            break;
+        case media_kind::video:
+            scan.videos.push_back(file_info_to_photo_info(finfo));
+            scan.video_bytes += finfo.file_size;
+            break;
+        case media_kind::sidecar:
+            scan.sidecars.push_back(file_info_to_photo_info(finfo));
+            scan.sidecar_bytes += finfo.file_size;
+            break;
+        default:
+            scan.other_files++;
+            break;
     }
 }
 
@@ -204,226 +524,1332 @@ photo_info photo_manager::file_info_to_photo_info(const file_info& finfo)
 }
 
 /*****************************************************************************/
-/* Function Name: list_all_photos                                            */
+/* Function Name: refresh_catalog                                            */
 /*                                                                           */
-/* Description: Lists all photos from the device's DCIM folder               */
+/* Description: Brings the catalog up to date with the tree under root and   */
+/*              saves it. Directories whose mtime matches the catalog are    */
+/*              not listed again; only their subdirectories are stat'ed.     */
+/*              Listings that failed are counted in errors                   */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
-/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Count failed listings               */
 /*****************************************************************************/
-std::vector<photo_info> photo_manager::list_all_photos()
+bool photo_manager::refresh_catalog(const std::string& root, uint64_t* errors)
 {
-    std::vector<photo_info> photos;
+    file_info info = afc->get_file_info(root);
+    if (!info.is_directory())
+    {
+        std::cerr << "Error: Media folder not found: " << root << std::endl;
+        return false;
+    }
 
-    if (!afc || !afc->is_connected())
+    std::set<std::string> seen;
+    size_t relisted = 0;
+    uint64_t failed = 0;
+    refresh_directory(root, info.modified_time, seen, relisted, failed);
+    if (errors)
     {
-        std::cerr << "Error: AFC not connected." << std::endl;
-        return photos;
+        *errors = failed;
     }
 
-    // iOS stores photos in /DCIM directory
-    std::cout << "Scanning DCIM folder for photos..." << std::endl;
-    scan_for_photos("/DCIM", photos);
+    // Keep records outside this root; drop the ones inside it that are gone
+    std::string prefix = root + "/";
+    for (const auto& item : catalog->all_directories())
+    {
+        if (item.first != root && item.first.compare(0, prefix.size(), prefix) != 0)
+        {
+            seen.insert(item.first);
+        }
+    }
+    catalog->retain(seen);
 
-    // Sort photos by filename for consistent ordering
-    std::sort(photos.begin(), photos.end(),
-        [](const photo_info& a, const photo_info& b) {
-            return a.filename < b.filename;
-        });
+    if (relisted > 0)
+    {
+        std::cout << "Catalog: re-listed " << relisted << " of " << seen.size() << " folders." << std::endl;
+    }
 
-    std::cout << "Found " << photos.size() << " photos." << std::endl;
-    return photos;
+    return catalog->save();
 }
 
 /*****************************************************************************/
-/* Function Name: list_photos_in_folder                                      */
+/* Function Name: refresh_directory                                          */
 /*                                                                           */
-/* Description: Lists photos in a specific folder                            */
+/* Description: Refreshes one catalog directory, listing it again only if    */
+/*              its mtime changed, then recurses into its subdirectories.    */
+/*              A directory mtime only moves when entries are added,         */
+/*              removed or renamed, so those are the changes detected. A     */
+/*              listing that fails is never recorded as current. The old     */
+/*              record is kept, or else the partial listing is stored with   */
+/*              no mtime. Either way the failure is counted in errors        */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
-/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Do not record failed listings       */
+/* 2026-10-16      S. Amalfitano         Count failed listings               */
 /*****************************************************************************/
-std::vector<photo_info> photo_manager::list_photos_in_folder(const std::string& folder_path)
+void photo_manager::refresh_directory(const std::string& path, uint64_t modified_time,
+                                      std::set<std::string>& seen, size_t& relisted, uint64_t& errors)
 {
-    std::vector<photo_info> photos;
+    seen.insert(path);
 
-    if (!afc || !afc->is_connected())
+    // Subdirectories to visit, with their current mtimes
+    std::vector<std::pair<std::string, uint64_t> > subdirectories;
+    const catalog_directory* cached = catalog->find(path);
+
+    if (cached && modified_time != 0 && cached->modified_time == modified_time)
     {
-        std::cerr << "Error: AFC not connected." << std::endl;
-        return photos;
+        for (const auto& entry : cached->entries)
+        {
+            if (entry.is_directory())
+            {
+                file_info current = afc->get_file_info(entry.full_path);
+                subdirectories.push_back(std::make_pair(entry.full_path, current.modified_time));
+            }
+        }
     }
+    else
+    {
+        bool complete = false;
+        std::vector<file_info> entries = afc->list_directory_with_info(path, &complete);
+        if (!complete)
+        {
+            errors++;
+        }
 
-    std::cout << "Scanning " << folder_path << " for photos..." << std::endl;
-    scan_for_photos(folder_path, photos);
-
-    // Sort photos by filename for consistent ordering
-    std::sort(photos.begin(), photos.end(),
-        [](const photo_info& a, const photo_info& b) {
-            return a.filename < b.filename;
-        });
+        if (!complete && cached)
+        {
+            // The old record stays, and its mtime no longer matches, so the
+            // next refresh lists the directory again
+            std::cerr << "Error: Failed to list " << path << " completely; keeping its catalog record." << std::endl;
+            for (const auto& entry : cached->entries)
+            {
+                if (entry.is_directory())
+                {
+                    file_info current = afc->get_file_info(entry.full_path);
+                    subdirectories.push_back(std::make_pair(entry.full_path, current.modified_time));
+                }
+            }
+        }
+        else
+        {
+            // Entries whose stat failed are left out, and an incomplete
+            // listing is stored without an mtime so it is listed again
+            std::vector<file_info> listed;
+            for (const auto& entry : entries)
+            {
+                if (entry.file_type == afc_file_type::unknown)
+                {
+                    continue;
+                }
+                if (entry.is_directory())
+                {
+                    subdirectories.push_back(std::make_pair(entry.full_path, entry.modified_time));
+                }
+                listed.push_back(entry);
+            }
+            catalog->store(path, complete ? modified_time : 0, listed);
+            relisted++;
+        }
+    }
 
-    std::cout << "Found " << photos.size() << " photos." << std::endl;
-    return photos;
+    for (const auto& subdirectory : subdirectories)
+    {
+        refresh_directory(subdirectory.first, subdirectory.second, seen, relisted, errors);
+    }
 }
 
 /*****************************************************************************/
-/* Function Name: list_videos                                                */
+/* Function Name: scan_media                                                 */
 /*                                                                           */
-/* Description: Lists all video files from the device's DCIM folder          */
+/* Description: Traverses root once, from the catalog when one is open or    */
+/*              with a pooled tree walk otherwise, classifying each file as  */
+/*              photo, video or sidecar. Each listing is sorted by filename  */
+/*              and the files are then grouped into assets. Catalog records  */
+/*              only notice added, removed or renamed files, so callers that */
+/*              compare sizes and mtimes pass use_catalog false to walk the  */
+/*              device instead. Any listing or stat that fails leaves the    */
+/*              scan marked incomplete                                       */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
-/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Group files into assets             */
+/* 2026-10-16      S. Amalfitano         Optional live walk                  */
+/* 2026-10-16      S. Amalfitano         Report incomplete traversals        */
 /*****************************************************************************/
-std::vector<photo_info> photo_manager::list_videos()
+media_scan photo_manager::scan_media(const std::string& root, bool use_catalog)
 {
-    std::vector<photo_info> videos;
+    media_scan scan;
 
     if (!afc || !afc->is_connected())
     {
         std::cerr << "Error: AFC not connected." << std::endl;
-        return videos;
+        return scan;
     }
 
-    std::cout << "Scanning DCIM folder for videos..." << std::endl;
-
-    // Scan DCIM directory
-    std::vector<std::string> entries = afc->list_directory("/DCIM");
-    for (const auto& entry : entries)
+    uint64_t catalog_errors = 0;
+    if (use_catalog && catalog && refresh_catalog(root, &catalog_errors))
     {
-        std::string full_path = "/DCIM/" + entry;
-        file_info finfo = afc->get_file_info(full_path);
+        scan.errors = catalog_errors;
+        scan.complete = (catalog_errors == 0);
 
-        if (finfo.is_directory)
+        std::string prefix = root + "/";
+        for (const auto& item : catalog->all_directories())
         {
-            // Scan subdirectory
-            std::vector<std::string> subentries = afc->list_directory(full_path);
-            for (const auto& subentry : subentries)
+            if (item.first != root && item.first.compare(0, prefix.size(), prefix) != 0)
             {
-                if (is_video_file(subentry))
+                continue;
+            }
+
+            for (const auto& entry : item.second.entries)
+            {
+                if (!entry.is_directory())
                 {
-                    std::string video_path = full_path + "/" + subentry;
-                    file_info vinfo = afc->get_file_info(video_path);
-                    photo_info pinfo = file_info_to_photo_info(vinfo);
-                    videos.push_back(pinfo);
+                    add_to_scan(entry, scan);
                 }
             }
         }
-        else if (is_video_file(entry))
-        {
-            photo_info pinfo = file_info_to_photo_info(finfo);
-            videos.push_back(pinfo);
-        }
     }
+    else
+    {
+        walk_stats walked;
+        bool listed = afc->walk_tree(root,
+            [&](const file_info& entry, unsigned depth)
+            {
+                (void)depth;
+                if (!entry.is_directory())
+                {
+                    add_to_scan(entry, scan);
+                }
+                return walk_action::descend;
+            }, &walked);
 
-    // Sort videos by filename for consistent ordering
-    std::sort(videos.begin(), videos.end(),
-        [](const photo_info& a, const photo_info& b) {
-            return a.filename < b.filename;
-        });
-
-    std::cout << "Found " << videos.size() << " videos." << std::endl;
-    return videos;
-}
+        scan.errors = walked.errors;
+        scan.complete = listed && walked.errors == 0;
+    }
 
-/*****************************************************************************/
-/* Function Name: download_photo                                             */
-/*                                                                           */
-/* Description: Downloads a single photo from the device                     */
-/*                                                                           */
-/* Date            Engineer              Comments                            */
-/* ------------------------------------------------------------------------- */
-/* 2026-02-12      S. Amalfitano         Initial implementation              */
-/*****************************************************************************/
-bool photo_manager::download_photo(const std::string& photo_path, const std::string& destination)
-{
-    if (!afc || !afc->is_connected())
+    // Sort by filename for consistent ordering
+    auto by_filename = [](const photo_info& a, const photo_info& b)
     {
-        std::cerr << "Error: AFC not connected." << std::endl;
-        return false;
-    }
+        return a.filename < b.filename;
+    };
+    std::sort(scan.photos.begin(), scan.photos.end(), by_filename);
+    std::sort(scan.videos.begin(), scan.videos.end(), by_filename);
+    std::sort(scan.sidecars.begin(), scan.sidecars.end(), by_filename);
 
-    std::cout << "Downloading: " << photo_path << " -> " << destination << std::endl;
-    return afc->download_file(photo_path, destination);
+    group_assets(scan);
+    return scan;
 }
 
 /*****************************************************************************/
-/* Function Name: download_all_photos                                        */
+/* Function Name: group_assets                                               */
 /*                                                                           */
-/* Description: Downloads all photos from the device to a local folder       */
+/* Description: Groups the classified files of a scan into assets by         */
+/*              directory and base name. The primary file is the unedited    */
+/*              photo, else the unedited video. A movie grouped with a photo */
+/*              makes it a Live Photo and is moved from the standalone       */
+/*              videos to live_videos                                        */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
-/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
 /*****************************************************************************/
-bool photo_manager::download_all_photos(const std::string& destination_folder)
+void photo_manager::group_assets(media_scan& scan)
 {
-    std::vector<photo_info> photos = list_all_photos();
-
-    if (photos.empty())
+    std::map<std::pair<std::string, std::string>, media_asset> groups;
+    for (const auto* listing : { &scan.photos, &scan.videos, &scan.sidecars })
     {
-        std::cout << "No photos found to download." << std::endl;
-        return true;
+        for (const auto& item : *listing)
+        {
+            size_t slash = item.full_path.find_last_of('/');
+            std::string directory = (slash == std::string::npos) ? "" : item.full_path.substr(0, slash);
+            std::string base_name = asset_base_name(item.filename);
+
+            media_asset& asset = groups[std::make_pair(directory, base_name)];
+            asset.directory = directory;
+            asset.base_name = base_name;
+            asset.components.push_back(item);
+            asset.total_bytes += item.file_size;
+        }
     }
 
-    int success_count = 0;
-    int fail_count = 0;
+    std::set<std::string> live_paths;
+    scan.assets.clear();
+    scan.assets.reserve(groups.size());
 
-    for (const auto& photo : photos)
+    for (auto& group : groups)
     {
-        std::string dest_path = destination_folder;
-        if (dest_path.back() != '/' && dest_path.back() != '\\')
+        media_asset& asset = group.second;
+        bool has_photo = false;
+        bool has_video = false;
+        size_t primary = 0;
+        int primary_rank = 4;
+
+        for (size_t i = 0; i < asset.components.size(); i++)
+        {
+            const photo_info& component = asset.components[i];
+            media_kind kind = classify_media(component.filename);
+            bool original = file_stem(component.filename) == asset.base_name;
+            int rank = (kind == media_kind::photo) ? (original ? 0 : 1) :
+                       (kind == media_kind::video) ? (original ? 2 : 3) : 4;
+
+            has_photo = has_photo || kind == media_kind::photo;
+            has_video = has_video || kind == media_kind::video;
+            if (rank < primary_rank)
+            {
+                primary_rank = rank;
+                primary = i;
+            }
+        }
+
+        asset.kind = has_photo ? media_kind::photo : (has_video ? media_kind::video : media_kind::sidecar);
+        asset.live_photo = has_photo && has_video;
+
+        photo_info primary_file = asset.components[primary];
+        asset.components.erase(asset.components.begin() + primary);
+        std::sort(asset.components.begin(), asset.components.end(),
+                  [](const photo_info& a, const photo_info& b) { return a.filename < b.filename; });
+        asset.components.insert(asset.components.begin(), primary_file);
+
+        if (asset.live_photo)
         {
-            dest_path += "/";
+            for (const photo_info& component : asset.components)
+            {
+                if (classify_media(component.filename) == media_kind::video)
+                {
+                    live_paths.insert(component.full_path);
+                }
+            }
         }
-        dest_path += photo.filename;
 
-        if (download_photo(photo.full_path, dest_path))
+        scan.assets.push_back(std::move(asset));
+    }
+
+    // Live Photo movies are part of their photo, not videos in their own right
+    std::vector<photo_info> standalone;
+    for (auto& video : scan.videos)
+    {
+        if (live_paths.count(video.full_path) != 0)
         {
-            success_count++;
+            scan.video_bytes -= video.file_size;
+            scan.live_video_bytes += video.file_size;
+            scan.live_videos.push_back(std::move(video));
         }
         else
         {
-            fail_count++;
+            standalone.push_back(std::move(video));
         }
     }
+    scan.videos.swap(standalone);
+}
+
+/*****************************************************************************/
+/* Function Name: list_all_photos                                            */
+/*                                                                           */
+/* Description: Lists all photos from the device's DCIM folder               */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Serve from the photo catalog        */
+/* 2026-10-16      S. Amalfitano         Use the unified media scan          */
+/* 2026-10-16      S. Amalfitano         Warn when the scan is incomplete    */
+/*****************************************************************************/
+std::vector<photo_info> photo_manager::list_all_photos()
+{
+    // iOS stores photos in /DCIM directory
+    std::cout << "Scanning DCIM folder for photos..." << std::endl;
+    media_scan scan = scan_media(media_root);
+    if (!scan.complete)
+    {
+        std::cerr << "Warning: Some folders could not be read; the photo list is incomplete." << std::endl;
+    }
+
+    std::cout << "Found " << scan.photos.size() << " photos." << std::endl;
+    return scan.photos;
+}
+
+/*****************************************************************************/
+/* Function Name: for_each_photo                                             */
+/*                                                                           */
+/* Description: Streams the photos under root to visitor as the walk stats   */
+/*              them, without building or sorting the whole list. The walk   */
+/*              runs on its own thread and hands photos over through a       */
+/*              bounded queue, so the visitor runs on the calling thread     */
+/*              while no walk lock is held. A full queue holds the walk      */
+/*              back, which bounds memory. Returning false from the visitor  */
+/*              stops the walk. Always lists the device and leaves the       */
+/*              catalog untouched. Returns false if root could not be listed */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Visit on the caller's thread        */
+/*****************************************************************************/
+bool photo_manager::for_each_photo(const photo_visitor& visitor, const std::string& root, walk_stats* stats)
+{
+    if (!afc || !afc->is_connected())
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    std::deque<photo_info> queue;
+    std::mutex queue_lock;
+    std::condition_variable queue_changed;
+    bool walk_done = false;
+    bool cancelled = false;
+    bool listed = false;
+
+    std::thread walker([&]()
+    {
+        listed = afc->walk_tree(root,
+            [&](const file_info& entry, unsigned depth)
+            {
+                (void)depth;
+                if (entry.is_directory() || classify_media(entry.filename) != media_kind::photo)
+                {
+                    return walk_action::descend;
+                }
+
+                std::unique_lock<std::mutex> guard(queue_lock);
+                queue_changed.wait(guard, [&]()
+                {
+                    return cancelled || queue.size() < photo_queue_capacity;
+                });
+                if (cancelled)
+                {
+                    return walk_action::stop;
+                }
+                queue.push_back(file_info_to_photo_info(entry));
+                queue_changed.notify_all();
+                return walk_action::descend;
+            },
+            stats);
+
+        std::lock_guard<std::mutex> guard(queue_lock);
+        walk_done = true;
+        queue_changed.notify_all();
+    });
+
+    while (true)
+    {
+        photo_info photo;
+        {
+            std::unique_lock<std::mutex> guard(queue_lock);
+            queue_changed.wait(guard, [&]()
+            {
+                return walk_done || !queue.empty();
+            });
+            if (queue.empty())
+            {
+                break;
+            }
+            photo = std::move(queue.front());
+            queue.pop_front();
+            queue_changed.notify_all();
+        }
+
+        if (!visitor(photo))
+        {
+            std::lock_guard<std::mutex> guard(queue_lock);
+            cancelled = true;
+            queue.clear();
+            queue_changed.notify_all();
+            break;
+        }
+    }
+
+    walker.join();
+    return listed;
+}
+
+/*****************************************************************************/
+/* Function Name: list_photos_in_folder                                      */
+/*                                                                           */
+/* Description: Lists photos in a specific folder                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Use the unified media scan          */
+/* 2026-10-16      S. Amalfitano         Warn when the scan is incomplete    */
+/*****************************************************************************/
+std::vector<photo_info> photo_manager::list_photos_in_folder(const std::string& folder_path)
+{
+    std::cout << "Scanning " << folder_path << " for photos..." << std::endl;
+    media_scan scan = scan_media(folder_path);
+    if (!scan.complete)
+    {
+        std::cerr << "Warning: Some folders could not be read; the photo list is incomplete." << std::endl;
+    }
+
+    std::cout << "Found " << scan.photos.size() << " photos." << std::endl;
+    return scan.photos;
+}
+
+/*****************************************************************************/
+/* Function Name: list_videos                                                */
+/*                                                                           */
+/* Description: Lists all video files from the device's DCIM folder          */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Fetch entry info in one listing     */
+/* 2026-10-16      S. Amalfitano         Serve from the photo catalog        */
+/* 2026-10-16      S. Amalfitano         Use the unified media scan          */
+/* 2026-10-16      S. Amalfitano         Warn when the scan is incomplete    */
+/*****************************************************************************/
+std::vector<photo_info> photo_manager::list_videos()
+{
+    std::cout << "Scanning DCIM folder for videos..." << std::endl;
+    media_scan scan = scan_media(media_root);
+    if (!scan.complete)
+    {
+        std::cerr << "Warning: Some folders could not be read; the video list is incomplete." << std::endl;
+    }
+
+    std::cout << "Found " << scan.videos.size() << " videos." << std::endl;
+    return scan.videos;
+}
+
+/*****************************************************************************/
+/* Function Name: read_headers                                               */
+/*                                                                           */
+/* Description: Parses the headers of items[begin, end) into results,        */
+/*              keeping the fetched bytes in fetched and flagging files that */
+/*              could not be read in failed. Reads the head of               */
+/*              every file, then in rounds whatever each parser asks for     */
+/*              next, with the ranged reads of a round spread over the AFC   */
+/*              pool. Returns the number of files that could not be read     */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+size_t photo_manager::read_headers(std::vector<photo_info>& items, size_t begin, size_t end,
+                                   std::vector<media_bytes>& fetched, std::vector<media_metadata>& results,
+                                   std::vector<bool>& failed, uint64_t& bytes_read)
+{
+    std::vector<size_t> pending;
+    std::vector<range_read> reads;
+    size_t failures = 0;
+
+    fetched.clear();
+    fetched.reserve(end - begin);
+    results.assign(end - begin, media_metadata());
+    failed.assign(end - begin, false);
+    for (size_t i = begin; i < end; i++)
+    {
+        fetched.push_back(media_bytes(items[i].file_size));
+        if (items[i].file_size == 0)
+        {
+            continue;
+        }
+
+        range_read head;
+        head.path = items[i].full_path;
+        head.length = static_cast<uint32_t>(std::min<uint64_t>(items[i].file_size, metadata_head_size));
+        reads.push_back(head);
+        pending.push_back(i);
+    }
+
+    for (int round = 0; round < metadata_max_rounds && !reads.empty(); round++)
+    {
+        afc->read_ranges(reads);
+
+        std::vector<size_t> next_pending;
+        std::vector<range_read> next_reads;
+        for (size_t r = 0; r < reads.size(); r++)
+        {
+            photo_info& item = items[pending[r]];
+            bytes_read += reads[r].data.size();
+            if (!reads[r].completed)
+            {
+                failed[pending[r] - begin] = true;
+                failures++;
+                continue;
+            }
+
+            media_bytes& file_bytes = fetched[pending[r] - begin];
+            file_bytes.add(reads[r].offset, reads[r].data);
+
+            media_metadata& metadata = results[pending[r] - begin];
+            media_metadata_parser parser(file_bytes);
+            metadata_status status = parser.parse(metadata);
+
+            item.capture_time = metadata.capture_time;
+            item.width = metadata.width;
+            item.height = metadata.height;
+            item.duration_seconds = metadata.duration_seconds;
+
+            if (status == metadata_status::need_range)
+            {
+                metadata_request request = parser.next_request();
+                range_read next;
+                next.path = item.full_path;
+                next.offset = request.offset;
+                next.length = request.length;
+                next_reads.push_back(next);
+                next_pending.push_back(pending[r]);
+            }
+        }
+
+        reads.swap(next_reads);
+        pending.swap(next_pending);
+    }
+
+    return failures;
+}
+
+/*****************************************************************************/
+/* Function Name: load_metadata                                              */
+/*                                                                           */
+/* Description: Fills in capture time, dimensions and duration from the file */
+/*              headers. Only the bytes the parsers ask for are read.        */
+/*              Returns false if any file could not be read                  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Rounds moved to read_headers        */
+/*****************************************************************************/
+bool photo_manager::load_metadata(std::vector<photo_info>& items)
+{
+    if (!is_connected())
+    {
+        std::cerr << "Error: Not connected to AFC" << std::endl;
+        return false;
+    }
+
+    size_t failures = 0;
+    uint64_t bytes_read = 0;
+    std::vector<media_bytes> fetched;
+    std::vector<media_metadata> results;
+    std::vector<bool> failed;
+
+    for (size_t batch = 0; batch < items.size(); batch += metadata_batch_size)
+    {
+        size_t batch_end = std::min(items.size(), batch + metadata_batch_size);
+        failures += read_headers(items, batch, batch_end, fetched, results, failed, bytes_read);
+    }
+
+    if (failures > 0)
+    {
+        std::cerr << "Error: Could not read metadata of " << failures << " files" << std::endl;
+    }
+    return failures == 0;
+}
+
+/*****************************************************************************/
+/* Function Name: cache_thumbnails                                           */
+/*                                                                           */
+/* Description: Extracts the embedded previews of items not yet in the cache */
+/*              for their mtime: the EXIF IFD1 JPEG, or the HEIF thumbnail   */
+/*              item. Headers are parsed as for load_metadata; previews not  */
+/*              already fetched with them are read as one more round of      */
+/*              ranged reads. The cache is saved after every batch           */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool photo_manager::cache_thumbnails(const std::vector<photo_info>& items, thumbnail_cache& cache,
+                                     thumbnail_stats* stats)
+{
+    if (!is_connected())
+    {
+        std::cerr << "Error: Not connected to AFC" << std::endl;
+        return false;
+    }
+
+    auto start_time = std::chrono::steady_clock::now();
+    thumbnail_stats totals;
+    bool saved = true;
+
+    std::vector<photo_info> missing;
+    for (const photo_info& item : items)
+    {
+        totals.files_checked++;
+        if (cache.contains(item.full_path, item.modified_time))
+        {
+            totals.files_cached++;
+        }
+        else
+        {
+            missing.push_back(item);
+        }
+    }
+
+    std::vector<media_bytes> fetched;
+    std::vector<media_metadata> results;
+    std::vector<bool> failed;
+
+    for (size_t batch = 0; batch < missing.size(); batch += metadata_batch_size)
+    {
+        size_t batch_end = std::min(missing.size(), batch + metadata_batch_size);
+        totals.files_failed += read_headers(missing, batch, batch_end, fetched, results, failed,
+                                            totals.bytes_downloaded);
+
+        // Previews outside the fetched header bytes, config before data
+        std::vector<range_read> reads;
+        for (size_t i = batch; i < batch_end; i++)
+        {
+            const media_preview& preview = results[i - batch].preview;
+            const media_bytes& file_bytes = fetched[i - batch];
+            if (failed[i - batch] || preview.format.empty())
+            {
+                continue;
+            }
+
+            range_read read;
+            read.path = missing[i].full_path;
+            if (preview.config_length > 0 && !file_bytes.find(preview.config_offset, preview.config_length))
+            {
+                read.offset = preview.config_offset;
+                read.length = preview.config_length;
+                reads.push_back(read);
+            }
+            if (!file_bytes.find(preview.data_offset, preview.data_length))
+            {
+                read.offset = preview.data_offset;
+                read.length = preview.data_length;
+                reads.push_back(read);
+            }
+        }
+
+        if (!reads.empty())
+        {
+            afc->read_ranges(reads);
+        }
+
+        size_t next_read = 0;
+        for (size_t i = batch; i < batch_end; i++)
+        {
+            const photo_info& item = missing[i];
+            const media_preview& preview = results[i - batch].preview;
+            media_bytes& file_bytes = fetched[i - batch];
+
+            // Files whose headers could not be read stay uncached and are retried next time
+            if (failed[i - batch])
+            {
+                continue;
+            }
+            while (next_read < reads.size() && reads[next_read].path == item.full_path)
+            {
+                range_read& read = reads[next_read++];
+                totals.bytes_downloaded += read.data.size();
+                if (read.completed)
+                {
+                    file_bytes.add(read.offset, read.data);
+                }
+            }
+
+            thumbnail entry;
+            if (preview.format.empty())
+            {
+                totals.files_without_thumbnail++;
+            }
+            else
+            {
+                const char* config = file_bytes.find(preview.config_offset, preview.config_length);
+                const char* data = file_bytes.find(preview.data_offset, preview.data_length);
+                if (!config || !data)
+                {
+                    totals.files_failed++;
+                    continue;
+                }
+                entry.format = preview.format;
+                entry.config.assign(config, config + preview.config_length);
+                entry.data.assign(data, data + preview.data_length);
+                totals.thumbnails_extracted++;
+            }
+
+            cache.store(item.full_path, item.modified_time, entry);
+        }
+
+        saved = cache.save() && saved;
+    }
+
+    totals.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    std::cout << "Thumbnails: " << totals.thumbnails_extracted << " extracted, "
+              << totals.files_cached << " already cached, "
+              << totals.files_without_thumbnail << " without a preview, "
+              << totals.files_failed << " failed (" << totals.bytes_downloaded << " bytes read in "
+              << totals.elapsed_seconds << " s)" << std::endl;
+
+    if (stats)
+    {
+        *stats = totals;
+    }
+    return saved && totals.files_failed == 0;
+}
+
+/*****************************************************************************/
+/* Function Name: download_photo                                             */
+/*                                                                           */
+/* Description: Downloads a single photo from the device                     */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Use parallel download path          */
+/*****************************************************************************/
+bool photo_manager::download_photo(const std::string& photo_path, const std::string& destination)
+{
+    if (!afc || !afc->is_connected())
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    std::cout << "Downloading: " << photo_path << " -> " << destination << std::endl;
+    return afc->download_file_parallel(photo_path, destination);
+}
+
+/*****************************************************************************/
+/* Function Name: download_all_photos                                        */
+/*                                                                           */
+/* Description: Downloads all photos from the device to a local folder,      */
+/*              each with its Live Photo movie and edit files. The files of  */
+/*              a photo download together and appear only once all of them   */
+/*              have arrived. Photos whose filenames are already taken by an */
+/*              earlier one are skipped                                      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Download photos as whole assets     */
+/* 2026-10-16      S. Amalfitano         Fail on an incomplete scan          */
+/*****************************************************************************/
+bool photo_manager::download_all_photos(const std::string& destination_folder)
+{
+    if (!afc || !afc->is_connected())
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    std::cout << "Scanning DCIM folder for photos..." << std::endl;
+    media_scan scan = scan_media(media_root);
+    if (!scan.complete)
+    {
+        std::cerr << "Warning: Some folders could not be read; photos in them will not be downloaded." << std::endl;
+    }
+
+    // The destination is flat, so the same filename in two DCIM subfolders
+    // would collide; the first asset to claim a name keeps it
+    std::vector<pending_group> groups;
+    std::set<std::string> claimed;
+    size_t skipped = 0;
+    for (const media_asset& asset : scan.assets)
+    {
+        if (asset.kind != media_kind::photo)
+        {
+            continue;
+        }
+
+        bool clash = false;
+        for (const photo_info& item : asset.components)
+        {
+            clash = clash || claimed.count(item.filename) > 0;
+        }
+        if (clash)
+        {
+            std::cerr << "Warning: Skipping " << asset.directory << "/" << asset.base_name
+                      << ", its filenames are already taken in " << destination_folder << std::endl;
+            skipped++;
+            continue;
+        }
+
+        pending_group group;
+        for (const photo_info& item : asset.components)
+        {
+            claimed.insert(item.filename);
+
+            pending_file file;
+            file.source_path = item.full_path;
+            file.final_path = local_fs::join_path(destination_folder, item.filename);
+            file.modified_seconds = static_cast<int64_t>(item.modified_time / 1000000000ULL);
+            group.push_back(file);
+        }
+        groups.push_back(group);
+    }
+
+    if (groups.empty())
+    {
+        std::cout << "No photos found to download." << std::endl;
+        return scan.complete;
+    }
+
+    if (!local_fs::make_directories(destination_folder))
+    {
+        std::cerr << "Error: Failed to create local directory: " << destination_folder << std::endl;
+        return false;
+    }
+
+    std::cout << "Downloading " << groups.size() << " photos..." << std::endl;
+    mirror_stats totals;
+    size_t failed_groups = download_groups(afc, groups, totals);
 
     std::cout << "\n=== Download Summary ===" << std::endl;
-    std::cout << "Successful: " << success_count << std::endl;
-    std::cout << "Failed: " << fail_count << std::endl;
+    std::cout << "Successful: " << (groups.size() - failed_groups) << " (" << totals.files_transferred
+              << " files)" << std::endl;
+    std::cout << "Failed: " << failed_groups << std::endl;
+    if (skipped > 0)
+    {
+        std::cout << "Skipped (name clash): " << skipped << std::endl;
+    }
+    if (!scan.complete)
+    {
+        std::cout << "Unreadable folders or files: " << scan.errors << std::endl;
+    }
     std::cout << "========================" << std::endl;
 
-    return (fail_count == 0);
+    return (scan.complete && failed_groups == 0 && totals.files_failed == 0);
+}
+
+/*****************************************************************************/
+/* Function Name: backup_photos                                              */
+/*                                                                           */
+/* Description: Backs up every photo, video and sidecar under DCIM into      */
+/*              destination_root, keeping the DCIM subfolder layout. Files   */
+/*              whose local copy already has the remote size and mtime are   */
+/*              skipped. The rest download in parallel to temporary files    */
+/*              that get the remote mtime and are then renamed over the      */
+/*              final name, so an interrupted run never leaves a truncated   */
+/*              file under a real name, and resumes where it stopped. The    */
+/*              files of an asset are moved into place together. The device  */
+/*              is walked even when a catalog is open, since files rewritten */
+/*              in place keep their catalog size and mtime. A folder that    */
+/*              cannot be listed counts in listing_errors and fails the run  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Transfer assets as whole groups     */
+/* 2026-10-16      S. Amalfitano         Compare against live file stats     */
+/* 2026-10-16      S. Amalfitano         Fail when DCIM is not fully listed  */
+/*****************************************************************************/
+bool photo_manager::backup_photos(const std::string& destination_root, mirror_stats* stats)
+{
+    if (!afc || !afc->is_connected())
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    if (!local_fs::make_directories(destination_root))
+    {
+        std::cerr << "Error: Failed to create local directory: " << destination_root << std::endl;
+        return false;
+    }
+
+    media_scan scan = scan_media(media_root, false);
+    mirror_stats totals;
+    totals.listing_errors = scan.complete ? 0 : std::max<uint64_t>(scan.errors, 1);
+    if (!scan.complete)
+    {
+        std::cerr << "Error: Some folders under " << media_root
+                  << " could not be read; their files are not backed up." << std::endl;
+    }
+
+    std::set<std::string> created_directories;
+    std::vector<pending_group> groups;
+    size_t prefix_length = std::string(media_root).size() + 1;
+
+    for (const media_asset& asset : scan.assets)
+    {
+        pending_group group;
+        for (const photo_info& item : asset.components)
+        {
+            std::string local_path = local_fs::join_path(destination_root, item.full_path.substr(prefix_length));
+            int64_t seconds = static_cast<int64_t>(item.modified_time / 1000000000ULL);
+            totals.files_checked++;
+
+            local_file_info local = local_fs::stat_path(local_path);
+            if (local.exists && !local.is_directory && local.file_size == item.file_size &&
+                std::llabs(local.modified_time - seconds) <= backup_mtime_tolerance)
+            {
+                totals.files_unchanged++;
+                continue;
+            }
+
+            std::string parent = local_fs::parent_path(local_path);
+            if (created_directories.insert(parent).second && !local_fs::make_directories(parent))
+            {
+                std::cerr << "Error: Failed to create local directory: " << parent << std::endl;
+            }
+
+            pending_file file;
+            file.source_path = item.full_path;
+            file.final_path = local_path;
+            file.modified_seconds = seconds;
+            group.push_back(file);
+        }
+
+        if (!group.empty())
+        {
+            groups.push_back(group);
+        }
+    }
+
+    download_groups(afc, groups, totals);
+
+    totals.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    if (stats)
+    {
+        *stats = totals;
+    }
+
+    std::cout << "\n=== Backup Summary ===" << std::endl;
+    std::cout << "Checked:    " << totals.files_checked << std::endl;
+    std::cout << "Copied:     " << totals.files_transferred << " (" << (totals.bytes_transferred / 1024.0 / 1024.0)
+              << " MB)" << std::endl;
+    std::cout << "Up to date: " << totals.files_unchanged << std::endl;
+    std::cout << "Failed:     " << totals.files_failed << std::endl;
+    if (totals.listing_errors > 0)
+    {
+        std::cout << "Unreadable: " << totals.listing_errors << std::endl;
+    }
+    std::cout << "======================" << std::endl;
+
+    return totals.files_failed == 0 && totals.listing_errors == 0;
+}
+
+/*****************************************************************************/
+/* Function Name: store_photos                                               */
+/*                                                                           */
+/* Description: Adds every photo, video and sidecar under DCIM to a shared   */
+/*              content-addressed store and records them as this device's    */
+/*              tree. Files unchanged since the device's last run are not    */
+/*              touched. For the rest only the first and last bytes are      */
+/*              read; a file whose size and probe match a stored object is   */
+/*              linked to it without downloading. Small files are read whole */
+/*              by the probe and stored from memory. Everything else is      */
+/*              downloaded in parallel into the store. Like backup_photos it */
+/*              walks the device rather than trusting catalog stats. If a    */
+/*              folder cannot be listed, no manifest entry is dropped and    */
+/*              the run fails                                                */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Walk files asset by asset           */
+/* 2026-10-16      S. Amalfitano         Compare against live file stats     */
+/* 2026-10-16      S. Amalfitano         Handle a batch that never started   */
+/* 2026-10-16      S. Amalfitano         Keep entries of unlisted folders    */
+/*****************************************************************************/
+bool photo_manager::store_photos(media_store& store, const std::string& device_id, store_stats* stats)
+{
+    if (!afc || !afc->is_connected())
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    // Asset by asset, so related files are probed and downloaded side by side
+    media_scan scan = scan_media(media_root, false);
+    std::vector<const photo_info*> media;
+    for (const media_asset& asset : scan.assets)
+    {
+        for (const auto& item : asset.components)
+        {
+            media.push_back(&item);
+        }
+    }
+
+    store_stats totals;
+    totals.listing_errors = scan.complete ? 0 : std::max<uint64_t>(scan.errors, 1);
+    if (!scan.complete)
+    {
+        std::cerr << "Error: Some folders under " << media_root
+                  << " could not be read; their manifest entries are kept." << std::endl;
+    }
+
+    store_manifest previous = store.load_manifest(device_id);
+    store_manifest current;
+    std::string tree_root = store.device_root(device_id);
+    size_t prefix_length = std::string(media_root).size() + 1;
+    size_t link_failures = 0;
+
+    // Files that need a probe, and the range reads covering them
+    std::vector<const photo_info*> candidates;
+    std::vector<range_read> reads;
+
+    for (const photo_info* item : media)
+    {
+        std::string relative_path = item->full_path.substr(prefix_length);
+        totals.files_checked++;
+
+        store_manifest::const_iterator known = previous.find(relative_path);
+        if (known != previous.end() && known->second.file_size == item->file_size &&
+            known->second.modified_time == item->modified_time && store.has_object(known->second.content_hash))
+        {
+            current.insert(*known);
+            totals.files_unchanged++;
+
+            std::string tree_path = local_fs::join_path(tree_root, relative_path);
+            if (!local_fs::stat_path(tree_path).exists && !store.link_into(known->second.content_hash, tree_path))
+            {
+                link_failures++;
+            }
+            continue;
+        }
+
+        range_read head;
+        head.path = item->full_path;
+        head.length = static_cast<uint32_t>(std::min<uint64_t>(item->file_size, 2 * store_probe_size));
+        if (item->file_size > 2 * store_probe_size)
+        {
+            head.length = store_probe_size;
+            range_read tail = head;
+            tail.offset = item->file_size - store_probe_size;
+            reads.push_back(head);
+            reads.push_back(tail);
+        }
+        else
+        {
+            reads.push_back(head);
+        }
+        candidates.push_back(item);
+    }
+
+    if (!reads.empty())
+    {
+        afc->read_ranges(reads);
+    }
+
+    // Resolve each candidate from its probe, queueing downloads for unknown contents
+    std::vector<transfer_request> requests;
+    std::vector<const photo_info*> requested;
+    std::vector<std::string> request_probes;
+    std::vector<std::pair<const photo_info*, std::string> > resolved;
+    size_t next_read = 0;
+
+    for (const photo_info* item : candidates)
+    {
+        bool split = item->file_size > 2 * store_probe_size;
+        const range_read& head = reads[next_read++];
+        const range_read* tail = split ? &reads[next_read++] : nullptr;
+
+        uint64_t probe_bytes = head.data.size() + (tail ? tail->data.size() : 0);
+        totals.bytes_downloaded += probe_bytes;
+        if (!head.completed || (tail && !tail->completed))
+        {
+            totals.files_failed++;
+            continue;
+        }
+
+        content_hasher hasher;
+        hasher.update(head.data.data(), head.data.size());
+        if (tail)
+        {
+            hasher.update(tail->data.data(), tail->data.size());
+        }
+        std::string probe_hash = hasher.hex_digest();
+
+        if (!split && probe_bytes == item->file_size)
+        {
+            // The probe read the whole file; its hash is the content hash
+            if (store.has_object(probe_hash))
+            {
+                totals.files_deduplicated++;
+                totals.bytes_deduplicated += item->file_size;
+            }
+            else if (store.add_data(head.data.data(), head.data.size(), probe_hash))
+            {
+                totals.files_downloaded++;
+            }
+            else
+            {
+                totals.files_failed++;
+                continue;
+            }
+            resolved.push_back(std::make_pair(item, probe_hash));
+            continue;
+        }
+
+        std::string content_hash = store.find_probe(item->file_size, probe_hash);
+        if (!content_hash.empty())
+        {
+            totals.files_deduplicated++;
+            totals.bytes_deduplicated += item->file_size;
+            resolved.push_back(std::make_pair(item, content_hash));
+            continue;
+        }
+
+        transfer_request request;
+        request.source_path = item->full_path;
+        request.destination_path = store.temp_path(device_id + "-" + std::to_string(requests.size()) + ".partial");
+        requests.push_back(request);
+        requested.push_back(item);
+        request_probes.push_back(probe_hash);
+    }
+
+    std::vector<transfer_stats> results;
+    if (!requests.empty())
+    {
+        afc->download_files(requests, &results);
+    }
+    if (results.size() != requests.size())
+    {
+        // The batch never started; count every request as failed
+        results.assign(requests.size(), transfer_stats());
+    }
+
+    for (size_t i = 0; i < requests.size(); i++)
+    {
+        const std::string& temp_path = requests[i].destination_path;
+        std::string content_hash = results[i].content_hash;
+        if (results[i].completed && content_hash.empty())
+        {
+            // A resumed download whose earlier part could not be re-read for hashing
+            content_hasher hasher;
+            if (hasher.update_from_file(temp_path, requested[i]->file_size))
+            {
+                content_hash = hasher.hex_digest();
+            }
+        }
+
+        if (!results[i].completed || content_hash.empty() || !store.add_file(temp_path, content_hash))
+        {
+            totals.files_failed++;
+            continue;
+        }
+
+        store.record_probe(requested[i]->file_size, request_probes[i], content_hash);
+        totals.files_downloaded++;
+        totals.bytes_downloaded += results[i].bytes_transferred;
+        resolved.push_back(std::make_pair(requested[i], content_hash));
+    }
+
+    for (const auto& item : resolved)
+    {
+        std::string relative_path = item.first->full_path.substr(prefix_length);
+        store_entry& entry = current[relative_path];
+        entry.content_hash = item.second;
+        entry.file_size = item.first->file_size;
+        entry.modified_time = item.first->modified_time;
+
+        if (!store.link_into(item.second, local_fs::join_path(tree_root, relative_path)))
+        {
+            link_failures++;
+        }
+    }
+
+    if (totals.listing_errors > 0)
+    {
+        // A file missing from this scan may sit in a folder that was not
+        // listed, so nothing is dropped from the manifest
+        for (const auto& item : previous)
+        {
+            current.insert(item);
+        }
+    }
+
+    bool saved = store.save_manifest(device_id, current) && store.save();
+    if (link_failures > 0)
+    {
+        std::cerr << "Warning: " << link_failures << " files could not be hard-linked into " << tree_root
+                  << "; they are recorded in the device manifest only." << std::endl;
+    }
+
+    totals.elapsed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+    if (stats)
+    {
+        *stats = totals;
+    }
+
+    std::cout << "\n=== Store Summary ===" << std::endl;
+    std::cout << "Checked:      " << totals.files_checked << std::endl;
+    std::cout << "Unchanged:    " << totals.files_unchanged << std::endl;
+    std::cout << "Deduplicated: " << totals.files_deduplicated << " (" << (totals.bytes_deduplicated / 1024.0 / 1024.0)
+              << " MB not downloaded)" << std::endl;
+    std::cout << "Downloaded:   " << totals.files_downloaded << " (" << (totals.bytes_downloaded / 1024.0 / 1024.0)
+              << " MB)" << std::endl;
+    std::cout << "Failed:       " << totals.files_failed << std::endl;
+    if (totals.listing_errors > 0)
+    {
+        std::cout << "Unreadable:   " << totals.listing_errors << std::endl;
+    }
+    std::cout << "=====================" << std::endl;
+
+    return saved && totals.files_failed == 0 && totals.listing_errors == 0;
+}
+
+/*****************************************************************************/
+/* Function Name: archive_all_photos                                         */
+/*                                                                           */
+/* Description: Streams the whole DCIM tree, including videos and edit       */
+/*              sidecars, into a tar archive on output_fd without staging    */
+/*              the files on disk                                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool photo_manager::archive_all_photos(int output_fd, const archive_options& options)
+{
+    if (!afc || !afc->is_connected())
+    {
+        std::cerr << "Error: AFC not connected." << std::endl;
+        return false;
+    }
+
+    return afc->export_tar("/DCIM", output_fd, options);
 }
 
 /*****************************************************************************/
 /* Function Name: get_photo_count                                            */
 /*                                                                           */
-/* Description: Returns the total number of photos on the device             */
+/* Description: Returns the total number of photos on the device, or -1      */
+/*              if some folder could not be listed                           */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Use the unified media scan          */
+/* 2026-10-16      S. Amalfitano         Return -1 for an incomplete scan    */
 /*****************************************************************************/
 int photo_manager::get_photo_count()
 {
-    return list_all_photos().size();
+    media_scan scan = scan_media(media_root);
+    if (!scan.complete)
+    {
+        return -1;
+    }
+    return scan.photos.size();
 }
 
 /*****************************************************************************/
 /* Function Name: get_video_count                                            */
 /*                                                                           */
-/* Description: Returns the total number of videos on the device             */
+/* Description: Returns the total number of videos on the device, or -1      */
+/*              if some folder could not be listed                           */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Use the unified media scan          */
+/* 2026-10-16      S. Amalfitano         Return -1 for an incomplete scan    */
 /*****************************************************************************/
 int photo_manager::get_video_count()
 {
-    return list_videos().size();
+    media_scan scan = scan_media(media_root);
+    if (!scan.complete)
+    {
+        return -1;
+    }
+    return scan.videos.size();
 }
 
 /*****************************************************************************/
@@ -434,6 +1860,8 @@ int photo_manager::get_video_count()
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Format numeric modification time    */
+/* 2026-10-16      S. Amalfitano         Show capture metadata when loaded   */
 /*****************************************************************************/
 void photo_manager::print_photo_list(const std::vector<photo_info>& photos)
 {
@@ -446,9 +1874,34 @@ void photo_manager::print_photo_list(const std::vector<photo_info>& photos)
         std::cout << "    Path: " << photo.full_path << std::endl;
         std::cout << "    Size: " << photo.file_size << " bytes" << std::endl;
         std::cout << "    Type: " << photo.file_type << std::endl;
-        if (!photo.modified_time.empty())
+        // AFC reports nanoseconds; show local time to the second
+        time_t seconds = static_cast<time_t>(photo.modified_time / 1000000000ULL);
+        struct tm* local = (photo.modified_time != 0) ? localtime(&seconds) : nullptr;
+        if (local)
+        {
+            char text[32];
+            strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", local);
+            std::cout << "    Modified: " << text << std::endl;
+        }
+        if (photo.capture_time != 0)
+        {
+            // Shown as recorded: UTC, or the camera clock when it kept no offset
+            time_t captured = static_cast<time_t>(photo.capture_time);
+            struct tm* when = gmtime(&captured);
+            if (when)
+            {
+                char text[32];
+                strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", when);
+                std::cout << "    Captured: " << text << std::endl;
+            }
+        }
+        if (photo.width != 0 && photo.height != 0)
+        {
+            std::cout << "    Dimensions: " << photo.width << "x" << photo.height << std::endl;
+        }
+        if (photo.duration_seconds > 0.0)
         {
-            std::cout << "    Modified: " << photo.modified_time << std::endl;
+            std::cout << "    Duration: " << photo.duration_seconds << " s" << std::endl;
         }
         std::cout << std::endl;
     }
@@ -456,6 +1909,30 @@ void photo_manager::print_photo_list(const std::vector<photo_info>& photos)
     std::cout << "=========================" << std::endl;
 }
 
+/*****************************************************************************/
+/* Function Name: sort_by_capture_time                                       */
+/*                                                                           */
+/* Description: Orders photos by capture time, then path. Photos without a   */
+/*              capture time fall back to their modification time            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void photo_manager::sort_by_capture_time(std::vector<photo_info>& photos)
+{
+    auto sort_time = [](const photo_info& photo) -> int64_t {
+        return photo.capture_time != 0 ? photo.capture_time
+                                       : static_cast<int64_t>(photo.modified_time / 1000000000ULL);
+    };
+
+    std::sort(photos.begin(), photos.end(), [&](const photo_info& a, const photo_info& b) {
+        int64_t time_a = sort_time(a);
+        int64_t time_b = sort_time(b);
+        return time_a != time_b ? time_a < time_b : a.full_path < b.full_path;
+    });
+}
+
 /*****************************************************************************/
 /* Function Name: is_connected                                               */
 /*                                                                           */
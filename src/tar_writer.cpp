@@ -0,0 +1,572 @@
+#include "tar_writer.h"
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <thread>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#endif
+
+// Tar archives are built from 512-byte blocks and end with two empty ones
+static const size_t tar_block_size = 512;
+static const size_t tar_end_blocks = 2;
+
+// Largest size the 11 octal digits of a ustar header can hold (8 GiB - 1)
+static const uint64_t max_ustar_size = 077777777777ULL;
+
+// Plain archives are written to the descriptor in blocks of this size
+static const size_t plain_output_size = 1024 * 1024;
+
+/*****************************************************************************/
+/* Function Name: write_all                                                  */
+/*                                                                           */
+/* Description: Writes a whole buffer to a file descriptor, retrying short   */
+/*              and interrupted writes                                       */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static bool write_all(int fd, const char* data, size_t length)
+{
+    while (length > 0)
+    {
+#ifdef _WIN32
+        int written = _write(fd, data, static_cast<unsigned int>(std::min<size_t>(length, 1 << 30)));
+#else
+        ssize_t written = write(fd, data, length);
+#endif
+        if (written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (written <= 0)
+        {
+            return false;
+        }
+
+        data += written;
+        length -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: split_ustar_name                                           */
+/*                                                                           */
+/* Description: Splits a member name into the 155-byte prefix and 100-byte   */
+/*              name fields of a ustar header at a slash. Returns false if   */
+/*              the name cannot be represented that way                      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static bool split_ustar_name(const std::string& name, std::string& prefix, std::string& base)
+{
+    if (name.size() <= 100)
+    {
+        prefix.clear();
+        base = name;
+        return true;
+    }
+
+    // Leave a trailing slash of a directory name on the base part
+    size_t search_end = name.size() >= 2 ? name.size() - 2 : 0;
+    for (size_t slash = name.rfind('/', search_end); slash != std::string::npos && slash > 0;
+         slash = name.rfind('/', slash - 1))
+    {
+        if (slash > 155)
+        {
+            continue;
+        }
+        if (name.size() - slash - 1 > 100)
+        {
+            break;
+        }
+
+        prefix = name.substr(0, slash);
+        base = name.substr(slash + 1);
+        return true;
+    }
+    return false;
+}
+
+/*****************************************************************************/
+/* Function Name: fill_header_block                                          */
+/*                                                                           */
+/* Description: Fills a ustar header block and its checksum. Name and        */
+/*              prefix must already fit their fields                         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static void fill_header_block(char* block, const std::string& name, const std::string& prefix, char type,
+                              uint64_t size, uint64_t mtime, unsigned mode)
+{
+    memset(block, 0, tar_block_size);
+
+    memcpy(block, name.data(), std::min<size_t>(name.size(), 100));
+    snprintf(block + 100, 8, "%07o", mode);
+    snprintf(block + 108, 8, "%07o", 0);
+    snprintf(block + 116, 8, "%07o", 0);
+    snprintf(block + 124, 12, "%011llo", static_cast<unsigned long long>(size));
+    snprintf(block + 136, 12, "%011llo", static_cast<unsigned long long>(mtime));
+    block[156] = type;
+    memcpy(block + 257, "ustar", 6);
+    memcpy(block + 263, "00", 2);
+    memcpy(block + 345, prefix.data(), std::min<size_t>(prefix.size(), 155));
+
+    // The checksum is computed with its own field filled with spaces
+    memset(block + 148, ' ', 8);
+    unsigned checksum = 0;
+    for (size_t i = 0; i < tar_block_size; i++)
+    {
+        checksum += static_cast<unsigned char>(block[i]);
+    }
+    snprintf(block + 148, 8, "%06o", checksum);
+    block[155] = ' ';
+}
+
+/*****************************************************************************/
+/* Function Name: tar_writer (Constructor)                                   */
+/*                                                                           */
+/* Description: Prepares an archive on output_fd. A compression_level above  */
+/*              zero wraps the tar stream in zstd, compressed on             */
+/*              compression_threads background threads (0 = one per core)    */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+tar_writer::tar_writer(int output_fd, int compression_level, unsigned compression_threads)
+    : fd(output_fd), compressor(nullptr), output_used(0), entry_remaining(0),
+      entry_written(0), entry_overflow(false), bytes_out(0), failed(false)
+{
+#ifdef _WIN32
+    // stdout and descriptors from _open default to text mode, which would mangle the archive
+    _setmode(fd, _O_BINARY);
+#endif
+
+    if (compression_level <= 0)
+    {
+        output.resize(plain_output_size);
+        return;
+    }
+
+    compressor = ZSTD_createCCtx();
+    if (!compressor)
+    {
+        std::cerr << "Error: Failed to create zstd compressor." << std::endl;
+        failed = true;
+        return;
+    }
+
+    if (compression_threads == 0)
+    {
+        compression_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    ZSTD_CCtx_setParameter(compressor, ZSTD_c_compressionLevel, compression_level);
+    ZSTD_CCtx_setParameter(compressor, ZSTD_c_checksumFlag, 1);
+    if (ZSTD_isError(ZSTD_CCtx_setParameter(compressor, ZSTD_c_nbWorkers, static_cast<int>(compression_threads))))
+    {
+        std::cerr << "Warning: zstd was built without threads, compressing on one core." << std::endl;
+    }
+
+    output.resize(ZSTD_CStreamOutSize());
+}
+
+/*****************************************************************************/
+/* Function Name: ~tar_writer (Destructor)                                   */
+/*                                                                           */
+/* Description: Frees the compressor. The archive is only complete if        */
+/*              finish was called                                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+tar_writer::~tar_writer()
+{
+    if (compressor)
+    {
+        ZSTD_freeCCtx(compressor);
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: add_directory                                              */
+/*                                                                           */
+/* Description: Adds a directory entry. mtime is in seconds since the epoch  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool tar_writer::add_directory(const std::string& name, uint64_t mtime)
+{
+    std::string directory_name = name;
+    if (directory_name.empty() || directory_name.back() != '/')
+    {
+        directory_name += "/";
+    }
+    return write_header(directory_name, '5', 0, mtime, 0755);
+}
+
+/*****************************************************************************/
+/* Function Name: begin_file                                                 */
+/*                                                                           */
+/* Description: Starts a regular file entry of the given size. Its contents  */
+/*              follow through write_data and the entry is closed with       */
+/*              end_file                                                     */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool tar_writer::begin_file(const std::string& name, uint64_t size, uint64_t mtime)
+{
+    entry_remaining = size;
+    entry_overflow = false;
+    return write_header(name, '0', size, mtime, 0644);
+}
+
+/*****************************************************************************/
+/* Function Name: write_data                                                 */
+/*                                                                           */
+/* Description: Appends contents to the open file entry. The header with     */
+/*              the size given to begin_file is already written, so data     */
+/*              beyond it cannot be stored: it is cut off to keep the        */
+/*              archive readable, and the entry is reported as failed        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Fail entries that outgrow the size  */
+/*****************************************************************************/
+bool tar_writer::write_data(const char* data, size_t length)
+{
+    size_t accepted = static_cast<size_t>(std::min<uint64_t>(length, entry_remaining));
+    entry_remaining -= accepted;
+    bool written = emit(data, accepted);
+
+    if (accepted < length)
+    {
+        if (!entry_overflow)
+        {
+            std::cerr << "Error: Archive entry grew past its recorded size; the archived copy is truncated."
+                      << std::endl;
+        }
+        entry_overflow = true;
+        return false;
+    }
+
+    return written;
+}
+
+/*****************************************************************************/
+/* Function Name: end_file                                                   */
+/*                                                                           */
+/* Description: Closes the open file entry and pads it to a block boundary.  */
+/*              If fewer bytes arrived than announced, the rest is zero      */
+/*              filled so the archive stays readable, and false is returned. */
+/*              An entry that received more than announced also fails        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Report overflowing entries          */
+/*****************************************************************************/
+bool tar_writer::end_file()
+{
+    bool complete = (entry_remaining == 0) && !entry_overflow;
+    entry_overflow = false;
+    if (entry_remaining > 0)
+    {
+        std::cerr << "Error: Archive entry is " << entry_remaining << " bytes short." << std::endl;
+        emit_zeros(static_cast<size_t>(entry_remaining));
+        entry_remaining = 0;
+    }
+
+    size_t partial = static_cast<size_t>(entry_written % tar_block_size);
+    entry_written = 0;
+    if (partial != 0)
+    {
+        emit_zeros(tar_block_size - partial);
+    }
+
+    return complete && !failed;
+}
+
+/*****************************************************************************/
+/* Function Name: finish                                                     */
+/*                                                                           */
+/* Description: Writes the end-of-archive blocks and flushes everything,     */
+/*              including the final zstd frame, to the descriptor            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool tar_writer::finish()
+{
+    emit_zeros(tar_block_size * tar_end_blocks);
+
+    if (compressor && !failed)
+    {
+        ZSTD_inBuffer input = { nullptr, 0, 0 };
+        size_t remaining = 0;
+        do
+        {
+            ZSTD_outBuffer out = { output.data(), output.size(), 0 };
+            remaining = ZSTD_compressStream2(compressor, &out, &input, ZSTD_e_end);
+            if (ZSTD_isError(remaining))
+            {
+                std::cerr << "Error: zstd compression failed: " << ZSTD_getErrorName(remaining) << std::endl;
+                failed = true;
+                break;
+            }
+            if (!write_all(fd, output.data(), out.pos))
+            {
+                failed = true;
+                break;
+            }
+            bytes_out += out.pos;
+        } while (remaining != 0);
+    }
+
+    flush_output();
+    return !failed;
+}
+
+/*****************************************************************************/
+/* Function Name: write_header                                               */
+/*                                                                           */
+/* Description: Writes the ustar header block of an entry, preceded by a     */
+/*              pax extended header when the name does not fit the ustar     */
+/*              fields or the size does not fit 11 octal digits              */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool tar_writer::write_header(const std::string& name, char type, uint64_t size, uint64_t mtime, unsigned mode)
+{
+    std::string prefix;
+    std::string base;
+    bool name_fits = split_ustar_name(name, prefix, base);
+
+    if (!name_fits || size > max_ustar_size)
+    {
+        if (!write_pax_header(name_fits ? std::string() : name, size > max_ustar_size ? size : 0))
+        {
+            return false;
+        }
+        if (!name_fits)
+        {
+            // Readers take the full name from the pax header
+            prefix.clear();
+            base = name.substr(0, 100);
+        }
+    }
+
+    char block[tar_block_size];
+    fill_header_block(block, base, prefix, type, std::min(size, max_ustar_size), mtime, mode);
+
+    entry_written = 0;
+    return emit(block, sizeof(block));
+}
+
+/*****************************************************************************/
+/* Function Name: write_pax_header                                           */
+/*                                                                           */
+/* Description: Writes a pax extended header carrying a long path and/or a   */
+/*              size over 8 GiB for the entry that follows. An empty name or */
+/*              a zero size leaves that record out                           */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool tar_writer::write_pax_header(const std::string& name, uint64_t size)
+{
+    std::string records;
+    std::vector<std::string> fields;
+    if (!name.empty())
+    {
+        fields.push_back("path=" + name);
+    }
+    if (size != 0)
+    {
+        fields.push_back("size=" + std::to_string(size));
+    }
+
+    // Each record is "<length> <key>=<value>\n" where length counts itself
+    for (const auto& field : fields)
+    {
+        size_t length = field.size() + 2;
+        size_t digits = std::to_string(length).size();
+        while (std::to_string(length + digits).size() != digits)
+        {
+            digits++;
+        }
+        records += std::to_string(length + digits) + " " + field + "\n";
+    }
+
+    char block[tar_block_size];
+    fill_header_block(block, "././@PaxHeader", "", 'x', records.size(), 0, 0644);
+
+    size_t partial = records.size() % tar_block_size;
+    return emit(block, sizeof(block)) &&
+           emit(records.data(), records.size()) &&
+           (partial == 0 || emit_zeros(tar_block_size - partial));
+}
+
+/*****************************************************************************/
+/* Function Name: emit                                                       */
+/*                                                                           */
+/* Description: Passes archive bytes on to the compressor, or buffers them   */
+/*              for the descriptor when writing a plain tar                  */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool tar_writer::emit(const char* data, size_t length)
+{
+    if (failed)
+    {
+        return false;
+    }
+    entry_written += length;
+
+    if (!compressor)
+    {
+        while (length > 0)
+        {
+            size_t copied = std::min(length, output.size() - output_used);
+            memcpy(output.data() + output_used, data, copied);
+            output_used += copied;
+            data += copied;
+            length -= copied;
+
+            if (output_used == output.size() && !flush_output())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // With worker threads zstd queues the input and compresses it in the background
+    ZSTD_inBuffer input = { data, length, 0 };
+    while (input.pos < input.size)
+    {
+        ZSTD_outBuffer out = { output.data(), output.size(), 0 };
+        size_t ret = ZSTD_compressStream2(compressor, &out, &input, ZSTD_e_continue);
+        if (ZSTD_isError(ret))
+        {
+            std::cerr << "Error: zstd compression failed: " << ZSTD_getErrorName(ret) << std::endl;
+            failed = true;
+            return false;
+        }
+        if (out.pos > 0)
+        {
+            if (!write_all(fd, output.data(), out.pos))
+            {
+                std::cerr << "Error: Failed to write archive." << std::endl;
+                failed = true;
+                return false;
+            }
+            bytes_out += out.pos;
+        }
+    }
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: emit_zeros                                                 */
+/*                                                                           */
+/* Description: Emits length zero bytes of padding                           */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool tar_writer::emit_zeros(size_t length)
+{
+    static const char zeros[tar_block_size] = {};
+
+    while (length > 0)
+    {
+        size_t count = std::min(length, sizeof(zeros));
+        if (!emit(zeros, count))
+        {
+            return false;
+        }
+        length -= count;
+    }
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: flush_output                                               */
+/*                                                                           */
+/* Description: Writes buffered plain archive bytes to the descriptor        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool tar_writer::flush_output()
+{
+    if (output_used == 0)
+    {
+        return !failed;
+    }
+
+    if (!write_all(fd, output.data(), output_used))
+    {
+        std::cerr << "Error: Failed to write archive." << std::endl;
+        failed = true;
+    }
+    bytes_out += output_used;
+    output_used = 0;
+    return !failed;
+}
+
+/*****************************************************************************/
+/* Function Name: bytes_written                                              */
+/*                                                                           */
+/* Description: Returns the number of bytes written to the descriptor so far */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+uint64_t tar_writer::bytes_written() const
+{
+    return bytes_out;
+}
+
+/*****************************************************************************/
+/* Function Name: good                                                       */
+/*                                                                           */
+/* Description: Returns false once any write or compression step failed      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool tar_writer::good() const
+{
+    return !failed;
+}
@@ -0,0 +1,438 @@
+#include "thumbnail_cache.h"
+#include "local_fs.h"
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+// File layout, all integers little-endian:
+//   header     magic[8]
+//   record     u32 path_length, u32 config_length, u32 data_length, format[4], u64 mtime,
+//              path, config, data
+// A record with an all-zero format marks a file that has no preview
+static const char cache_magic[8] = { 'I', 'D', 'V', 'T', 'H', 'M', '0', '1' };
+static const size_t magic_size = sizeof(cache_magic);
+static const size_t record_header_size = 24;
+
+/*****************************************************************************/
+/* Function Name: get_u32                                                    */
+/*                                                                           */
+/* Description: Decodes a little-endian 32-bit value                         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static uint32_t get_u32(const char* p)
+{
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<uint32_t>(b[0]) | (static_cast<uint32_t>(b[1]) << 8) |
+           (static_cast<uint32_t>(b[2]) << 16) | (static_cast<uint32_t>(b[3]) << 24);
+}
+
+/*****************************************************************************/
+/* Function Name: put_u32                                                    */
+/*                                                                           */
+/* Description: Appends a little-endian 32-bit value                         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static void put_u32(std::string& out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        out.push_back(static_cast<char>((value >> (i * 8)) & 0xff));
+    }
+}
+
+/*****************************************************************************/
+/* Function Name: append_record                                              */
+/*                                                                           */
+/* Description: Appends one encoded record to out                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+static void append_record(std::string& out, const std::string& path, uint64_t modified_time,
+                          const thumbnail& preview)
+{
+    char format[4] = { 0, 0, 0, 0 };
+    std::memcpy(format, preview.format.data(), std::min<size_t>(preview.format.size(), 4));
+
+    put_u32(out, static_cast<uint32_t>(path.size()));
+    put_u32(out, static_cast<uint32_t>(preview.config.size()));
+    put_u32(out, static_cast<uint32_t>(preview.data.size()));
+    out.append(format, 4);
+    put_u32(out, static_cast<uint32_t>(modified_time & 0xffffffffu));
+    put_u32(out, static_cast<uint32_t>(modified_time >> 32));
+    out += path;
+    out.append(preview.config.begin(), preview.config.end());
+    out.append(preview.data.begin(), preview.data.end());
+}
+
+/*****************************************************************************/
+/* Function Name: thumbnail_cache (Constructor)                              */
+/*                                                                           */
+/* Description: Creates an empty cache backed by the given file              */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+thumbnail_cache::thumbnail_cache(const std::string& path)
+    : cache_path(path), file_length(0), live_bytes(0), rewrite(true)
+{
+}
+
+/*****************************************************************************/
+/* Function Name: load                                                       */
+/*                                                                           */
+/* Description: Indexes the records of the cache file; the previews stay on  */
+/*              disk. A record cut short by an interrupted save ends the     */
+/*              index, and the next save rewrites the file without it        */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool thumbnail_cache::load()
+{
+    entries.clear();
+    pending.clear();
+    file_length = 0;
+    live_bytes = 0;
+    rewrite = true;
+
+    std::ifstream in(cache_path, std::ios::binary);
+    if (!in.is_open())
+    {
+        return false;
+    }
+
+    in.seekg(0, std::ios::end);
+    uint64_t total = static_cast<uint64_t>(in.tellg());
+    in.seekg(0, std::ios::beg);
+
+    char magic[magic_size];
+    if (!in.read(magic, magic_size) || std::memcmp(magic, cache_magic, magic_size) != 0)
+    {
+        std::cerr << "Warning: Ignoring damaged thumbnail cache: " << cache_path << std::endl;
+        return false;
+    }
+
+    uint64_t position = magic_size;
+    char header[record_header_size];
+    while (position + record_header_size <= total && in.read(header, record_header_size))
+    {
+        uint32_t path_length = get_u32(header);
+        cache_entry entry;
+        entry.config_length = get_u32(header + 4);
+        entry.data_length = get_u32(header + 8);
+        entry.modified_time = static_cast<uint64_t>(get_u32(header + 16)) |
+                              (static_cast<uint64_t>(get_u32(header + 20)) << 32);
+        entry.offset = position + record_header_size + path_length;
+
+        uint64_t record_size = record_header_size + static_cast<uint64_t>(path_length) +
+                               entry.config_length + entry.data_length;
+        std::string path(path_length, '\0');
+        if (position + record_size > total || !in.read(&path[0], path_length))
+        {
+            break;
+        }
+        entry.format.assign(header + 12, 4);
+        entry.format.erase(std::min(entry.format.find('\0'), entry.format.size()));
+
+        auto existing = entries.find(path);
+        if (existing != entries.end())
+        {
+            live_bytes -= record_header_size + existing->first.size() +
+                          existing->second.config_length + existing->second.data_length;
+        }
+        entries[path] = entry;
+        live_bytes += record_size;
+
+        position += record_size;
+        in.seekg(static_cast<std::streamoff>(position), std::ios::beg);
+    }
+
+    file_length = position;
+    rewrite = position != total;
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: save                                                       */
+/*                                                                           */
+/* Description: Appends the records added since the last save. The file is   */
+/*              rewritten instead when it is missing, damaged, or more than  */
+/*              half of it is superseded records                             */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool thumbnail_cache::save()
+{
+    if (!rewrite && pending.empty())
+    {
+        return true;
+    }
+
+    uint64_t record_bytes = (file_length > magic_size ? file_length - magic_size : 0) + pending.size();
+    if (rewrite || record_bytes > 2 * live_bytes)
+    {
+        return compact();
+    }
+
+    std::ofstream out(cache_path, std::ios::binary | std::ios::app);
+    out.write(pending.data(), static_cast<std::streamsize>(pending.size()));
+    out.close();
+    if (out.fail())
+    {
+        std::cerr << "Error: Failed to write thumbnail cache: " << cache_path << std::endl;
+        rewrite = true;
+        return false;
+    }
+
+    file_length += pending.size();
+    pending.clear();
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: compact                                                    */
+/*                                                                           */
+/* Description: Writes every current record to a new file, which replaces    */
+/*              the old one only once fully written and both are closed      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Close the old file before replacing */
+/*****************************************************************************/
+bool thumbnail_cache::compact()
+{
+    local_fs::make_directories(local_fs::parent_path(cache_path));
+    std::string temp_path = cache_path + ".tmp";
+    std::ifstream in(cache_path, std::ios::binary);
+    std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+    out.write(cache_magic, magic_size);
+
+    std::map<std::string, cache_entry> written;
+    uint64_t position = magic_size;
+    bool read_failed = false;
+
+    for (const auto& item : entries)
+    {
+        thumbnail preview;
+        if (!read_entry(in, item.second, preview))
+        {
+            read_failed = true;
+            continue;
+        }
+
+        std::string record;
+        append_record(record, item.first, item.second.modified_time, preview);
+        out.write(record.data(), static_cast<std::streamsize>(record.size()));
+
+        cache_entry entry = item.second;
+        entry.offset = position + record_header_size + item.first.size();
+        written[item.first] = entry;
+        position += record.size();
+    }
+    out.close();
+
+    // Windows cannot replace a file that is still open
+    in.close();
+
+    if (out.fail() || !local_fs::rename_replace(temp_path, cache_path))
+    {
+        std::cerr << "Error: Failed to write thumbnail cache: " << cache_path << std::endl;
+        local_fs::remove_file(temp_path);
+        return false;
+    }
+
+    if (read_failed)
+    {
+        std::cerr << "Warning: Dropped unreadable thumbnail cache records" << std::endl;
+    }
+
+    entries.swap(written);
+    pending.clear();
+    file_length = position;
+    live_bytes = position - magic_size;
+    rewrite = false;
+    return true;
+}
+
+/*****************************************************************************/
+/* Function Name: lookup                                                     */
+/*                                                                           */
+/* Description: Returns the entry for path if it was cached for the same     */
+/*              mtime, or nullptr                                            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+const thumbnail_cache::cache_entry* thumbnail_cache::lookup(const std::string& path,
+                                                            uint64_t modified_time) const
+{
+    auto it = entries.find(path);
+    if (it == entries.end() || it->second.modified_time != modified_time)
+    {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+/*****************************************************************************/
+/* Function Name: read_entry                                                 */
+/*                                                                           */
+/* Description: Reads the preview of an entry, from the cache file or from   */
+/*              the records not yet saved                                    */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool thumbnail_cache::read_entry(std::ifstream& in, const cache_entry& entry, thumbnail& preview) const
+{
+    preview.format = entry.format;
+    preview.config.resize(entry.config_length);
+    preview.data.resize(entry.data_length);
+
+    if (entry.offset >= file_length)
+    {
+        uint64_t start = entry.offset - file_length;
+        if (start + entry.config_length + entry.data_length > pending.size())
+        {
+            return false;
+        }
+        const char* source = pending.data() + start;
+        std::copy(source, source + entry.config_length, preview.config.begin());
+        std::copy(source + entry.config_length, source + entry.config_length + entry.data_length,
+                  preview.data.begin());
+        return true;
+    }
+
+    if (!in.is_open())
+    {
+        return false;
+    }
+
+    in.clear();
+    in.seekg(static_cast<std::streamoff>(entry.offset), std::ios::beg);
+    if (entry.config_length > 0)
+    {
+        in.read(&preview.config[0], entry.config_length);
+    }
+    if (entry.data_length > 0)
+    {
+        in.read(&preview.data[0], entry.data_length);
+    }
+    return !in.fail();
+}
+
+/*****************************************************************************/
+/* Function Name: contains                                                   */
+/*                                                                           */
+/* Description: Returns true if the file was processed at this mtime,        */
+/*              whether or not it had a preview                              */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool thumbnail_cache::contains(const std::string& path, uint64_t modified_time) const
+{
+    return lookup(path, modified_time) != nullptr;
+}
+
+/*****************************************************************************/
+/* Function Name: find                                                       */
+/*                                                                           */
+/* Description: Reads the cached preview of a file. Returns false if the     */
+/*              file is not cached at this mtime or has no preview           */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+bool thumbnail_cache::find(const std::string& path, uint64_t modified_time, thumbnail& preview) const
+{
+    const cache_entry* entry = lookup(path, modified_time);
+    if (!entry || entry->format.empty())
+    {
+        return false;
+    }
+
+    std::ifstream in;
+    if (entry->offset < file_length)
+    {
+        in.open(cache_path, std::ios::binary);
+    }
+    return read_entry(in, *entry, preview);
+}
+
+/*****************************************************************************/
+/* Function Name: store                                                      */
+/*                                                                           */
+/* Description: Records the preview of a file, replacing any older one. An   */
+/*              empty format records that the file has no preview            */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void thumbnail_cache::store(const std::string& path, uint64_t modified_time, const thumbnail& preview)
+{
+    auto existing = entries.find(path);
+    if (existing != entries.end())
+    {
+        live_bytes -= record_header_size + path.size() +
+                      existing->second.config_length + existing->second.data_length;
+    }
+
+    size_t start = pending.size();
+    append_record(pending, path, modified_time, preview);
+
+    cache_entry entry;
+    entry.modified_time = modified_time;
+    entry.offset = file_length + start + record_header_size + path.size();
+    entry.config_length = static_cast<uint32_t>(preview.config.size());
+    entry.data_length = static_cast<uint32_t>(preview.data.size());
+    entry.format = preview.format.substr(0, 4);
+    entries[path] = entry;
+    live_bytes += pending.size() - start;
+}
+
+/*****************************************************************************/
+/* Function Name: size                                                       */
+/*                                                                           */
+/* Description: Returns the number of files recorded                         */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+size_t thumbnail_cache::size() const
+{
+    return entries.size();
+}
+
+/*****************************************************************************/
+/* Function Name: path                                                       */
+/*                                                                           */
+/* Description: Returns the file the cache is stored in                      */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+const std::string& thumbnail_cache::path() const
+{
+    return cache_path;
+}
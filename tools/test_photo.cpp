@@ -2,6 +2,14 @@
 #include <string>
 #include <limits>
 #include <algorithm>
+#include <ctime>
+#include <cstdlib>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 #include "device_manager.h"
 #include "photo_manager.h"
 
@@ -13,22 +21,41 @@
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Archive options                     */
+/* 2026-10-16      S. Amalfitano         Catalog option                      */
+/* 2026-10-16      S. Amalfitano         Backup option                       */
+/* 2026-10-16      S. Amalfitano         Media store option                  */
+/* 2026-10-16      S. Amalfitano         Capture date option                 */
+/* 2026-10-16      S. Amalfitano         Thumbnail cache option              */
+/* 2026-10-16      S. Amalfitano         Streaming list option               */
 /*****************************************************************************/
 void print_usage(const char* program_name)
 {
     std::cout << "Usage: " << program_name << " [OPTIONS]\n" << std::endl;
     std::cout << "OPTIONS:" << std::endl;
     std::cout << "  -l, --list           List all photos and exit" << std::endl;
+    std::cout << "  -t, --by-date        Read capture dates and list photos in capture order" << std::endl;
+    std::cout << "  -f, --first N        Print the first N photos as they are found and exit" << std::endl;
     std::cout << "  -d, --download DIR   Download all photos to DIR and exit" << std::endl;
+    std::cout << "  -b, --backup DIR     Incrementally back up DCIM into DIR, keeping folders" << std::endl;
+    std::cout << "  -S, --store DIR      Add DCIM to a deduplicating store shared by devices" << std::endl;
+    std::cout << "  -T, --thumbnails FILE  Cache embedded photo previews in FILE" << std::endl;
     std::cout << "  -s, --stats          Show photo statistics and exit" << std::endl;
+    std::cout << "  -a, --archive FILE   Stream DCIM into a tar archive (- for stdout)" << std::endl;
+    std::cout << "  -z, --zstd           Compress the archive with zstd" << std::endl;
+    std::cout << "  -n, --no-catalog     Rescan the device instead of using the photo catalog" << std::endl;
     std::cout << "  -h, --help           Display this help message" << std::endl;
     std::cout << "\nInteractive Mode:" << std::endl;
     std::cout << "  Run without options to enter interactive menu" << std::endl;
     std::cout << "\nExamples:" << std::endl;
     std::cout << "  " << program_name << "                      # Interactive mode" << std::endl;
     std::cout << "  " << program_name << " -l                   # List all photos" << std::endl;
+    std::cout << "  " << program_name << " -l -t                # List photos by capture date" << std::endl;
     std::cout << "  " << program_name << " -d ./my_photos       # Download all photos" << std::endl;
+    std::cout << "  " << program_name << " -b ./backup          # Copy only new or changed files" << std::endl;
+    std::cout << "  " << program_name << " -T thumbs.cache      # Cache previews for a grid" << std::endl;
     std::cout << "  " << program_name << " -s                   # Show statistics" << std::endl;
+    std::cout << "  " << program_name << " -a - -z > dcim.tar.zst  # Archive to stdout" << std::endl;
 }
 
 /*****************************************************************************/
@@ -62,8 +89,9 @@ void print_menu()
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Optional capture date order         */
 /*****************************************************************************/
-std::vector<photo_info> list_photos_interactive(photo_manager& photos)
+std::vector<photo_info> list_photos_interactive(photo_manager& photos, bool by_date = false)
 {
     std::cout << "\nScanning for photos..." << std::endl;
     std::vector<photo_info> photo_list = photos.list_all_photos();
@@ -74,18 +102,74 @@ std::vector<photo_info> list_photos_interactive(photo_manager& photos)
         return photo_list;
     }
 
+    if (by_date)
+    {
+        std::cout << "Reading capture dates..." << std::endl;
+        photos.load_metadata(photo_list);
+        photos.sort_by_capture_time(photo_list);
+    }
+
     std::cout << "\n=== Photo List (" << photo_list.size() << " photos) ===" << std::endl;
     for (size_t i = 0; i < photo_list.size(); i++)
     {
         const auto& photo = photo_list[i];
         std::cout << "[" << (i + 1) << "] " << photo.filename;
-        std::cout << " (" << photo.file_size << " bytes, " << photo.file_type << ")" << std::endl;
+        std::cout << " (" << photo.file_size << " bytes, " << photo.file_type;
+        if (photo.capture_time != 0)
+        {
+            time_t captured = static_cast<time_t>(photo.capture_time);
+            struct tm* when = gmtime(&captured);
+            char text[32];
+            if (when && strftime(text, sizeof(text), "%Y-%m-%d %H:%M:%S", when) > 0)
+            {
+                std::cout << ", " << text;
+            }
+        }
+        if (photo.width != 0 && photo.height != 0)
+        {
+            std::cout << ", " << photo.width << "x" << photo.height;
+        }
+        std::cout << ")" << std::endl;
     }
     std::cout << "=========================" << std::endl;
 
     return photo_list;
 }
 
+/*****************************************************************************/
+/* Function Name: stream_photos                                              */
+/*                                                                           */
+/* Description: Prints photos while the device is still being walked and     */
+/*              stops the walk once limit photos have been shown             */
+/*                                                                           */
+/* Date            Engineer              Comments                            */
+/* ------------------------------------------------------------------------- */
+/* 2026-10-16      S. Amalfitano         Initial implementation              */
+/*****************************************************************************/
+void stream_photos(photo_manager& photos, size_t limit)
+{
+    std::cout << "\nStreaming the first " << limit << " photos..." << std::endl;
+
+    size_t shown = 0;
+    bool listed = photos.for_each_photo(
+        [&](const photo_info& photo)
+        {
+            shown++;
+            std::cout << "[" << shown << "] " << photo.full_path;
+            std::cout << " (" << photo.file_size << " bytes, " << photo.file_type << ")" << std::endl;
+            return shown < limit;
+        });
+
+    if (!listed)
+    {
+        std::cout << "Could not list the DCIM folder." << std::endl;
+    }
+    else if (shown == 0)
+    {
+        std::cout << "No photos found on device." << std::endl;
+    }
+}
+
 /*****************************************************************************/
 /* Function Name: list_videos_interactive                                    */
 /*                                                                           */
@@ -124,34 +208,43 @@ void list_videos_interactive(photo_manager& photos)
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Single media scan                   */
+/* 2026-10-16      S. Amalfitano         Count grouped assets                */
+/* 2026-10-16      S. Amalfitano         Flag incomplete totals              */
 /*****************************************************************************/
 void show_statistics(photo_manager& photos)
 {
     std::cout << "\nGathering statistics..." << std::endl;
 
-    std::vector<photo_info> photo_list = photos.list_all_photos();
-    std::vector<photo_info> video_list = photos.list_videos();
-
-    uint64_t total_photo_size = 0;
-    uint64_t total_video_size = 0;
+    media_scan scan = photos.scan_media();
 
-    for (const auto& photo : photo_list)
+    size_t photo_assets = 0;
+    size_t video_assets = 0;
+    size_t live_photos = 0;
+    for (const auto& asset : scan.assets)
     {
-        total_photo_size += photo.file_size;
+        photo_assets += (asset.kind == media_kind::photo) ? 1 : 0;
+        video_assets += (asset.kind == media_kind::video) ? 1 : 0;
+        live_photos += asset.live_photo ? 1 : 0;
     }
+    uint64_t total_bytes = scan.photo_bytes + scan.video_bytes + scan.live_video_bytes + scan.sidecar_bytes;
 
-    for (const auto& video : video_list)
+    std::cout << "\n=== Photo Library Statistics ===" << std::endl;
+    std::cout << "Photos: " << photo_assets << " (" << live_photos << " Live Photos)" << std::endl;
+    std::cout << "  Image files: " << scan.photos.size() << ", "
+              << (scan.photo_bytes / 1024.0 / 1024.0) << " MB" << std::endl;
+    std::cout << "  Live Photo movies: " << scan.live_videos.size() << ", "
+              << (scan.live_video_bytes / 1024.0 / 1024.0) << " MB" << std::endl;
+    std::cout << "Videos: " << video_assets << std::endl;
+    std::cout << "  Total size: " << (scan.video_bytes / 1024.0 / 1024.0) << " MB" << std::endl;
+    std::cout << "Sidecars: " << scan.sidecars.size() << std::endl;
+    std::cout << "  Total size: " << (scan.sidecar_bytes / 1024.0 / 1024.0) << " MB" << std::endl;
+    std::cout << "Total items: " << (photo_assets + video_assets) << std::endl;
+    std::cout << "Total size: " << (total_bytes / 1024.0 / 1024.0) << " MB" << std::endl;
+    if (!scan.complete)
     {
-        total_video_size += video.file_size;
+        std::cout << "Incomplete: " << scan.errors << " folders or files could not be read" << std::endl;
     }
-
-    std::cout << "\n=== Photo Library Statistics ===" << std::endl;
-    std::cout << "Photos: " << photo_list.size() << std::endl;
-    std::cout << "  Total size: " << (total_photo_size / 1024.0 / 1024.0) << " MB" << std::endl;
-    std::cout << "Videos: " << video_list.size() << std::endl;
-    std::cout << "  Total size: " << (total_video_size / 1024.0 / 1024.0) << " MB" << std::endl;
-    std::cout << "Total items: " << (photo_list.size() + video_list.size()) << std::endl;
-    std::cout << "Total size: " << ((total_photo_size + total_video_size) / 1024.0 / 1024.0) << " MB" << std::endl;
     std::cout << "================================" << std::endl;
 }
 
@@ -353,12 +446,19 @@ void interactive_mode(photo_manager& photos)
 /*****************************************************************************/
 /* Function Name: main                                                       */
 /*                                                                           */
-/* Description: Entry point for photo manager test. Supports both           */
+/* Description: Entry point for photo manager test. Supports both            */
 /*              interactive mode and command-line options                    */
 /*                                                                           */
 /* Date            Engineer              Comments                            */
 /* ------------------------------------------------------------------------- */
 /* 2026-02-12      S. Amalfitano         Initial implementation              */
+/* 2026-10-16      S. Amalfitano         Tar/zstd archive export             */
+/* 2026-10-16      S. Amalfitano         Per-device photo catalog            */
+/* 2026-10-16      S. Amalfitano         Incremental backup mode             */
+/* 2026-10-16      S. Amalfitano         Content-addressed media store       */
+/* 2026-10-16      S. Amalfitano         List by capture date                */
+/* 2026-10-16      S. Amalfitano         Embedded thumbnail cache            */
+/* 2026-10-16      S. Amalfitano         Streaming photo list                */
 /*****************************************************************************/
 int main(int argc, char* argv[])
 {
@@ -366,6 +466,14 @@ int main(int argc, char* argv[])
     bool list_only = false;
     bool stats_only = false;
     std::string download_dir;
+    std::string backup_dir;
+    std::string store_dir;
+    std::string thumbnail_path;
+    std::string archive_path;
+    archive_options archive;
+    bool use_catalog = true;
+    bool by_date = false;
+    size_t first_count = 0;
 
     // Parse command-line arguments
     for (int i = 1; i < argc; i++)
@@ -377,6 +485,20 @@ int main(int argc, char* argv[])
             list_only = true;
             interactive = false;
         }
+        else if (arg == "-f" || arg == "--first")
+        {
+            if (i + 1 < argc && strtoull(argv[i + 1], nullptr, 10) > 0)
+            {
+                first_count = static_cast<size_t>(strtoull(argv[i + 1], nullptr, 10));
+                interactive = false;
+                i++;
+            }
+            else
+            {
+                std::cerr << "Error: -f/--first requires a positive count" << std::endl;
+                return 1;
+            }
+        }
         else if (arg == "-s" || arg == "--stats")
         {
             stats_only = true;
@@ -396,6 +518,74 @@ int main(int argc, char* argv[])
                 return 1;
             }
         }
+        else if (arg == "-b" || arg == "--backup")
+        {
+            if (i + 1 < argc)
+            {
+                backup_dir = argv[i + 1];
+                interactive = false;
+                i++;
+            }
+            else
+            {
+                std::cerr << "Error: -b/--backup requires a directory path" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "-S" || arg == "--store")
+        {
+            if (i + 1 < argc)
+            {
+                store_dir = argv[i + 1];
+                interactive = false;
+                i++;
+            }
+            else
+            {
+                std::cerr << "Error: -S/--store requires a directory path" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "-T" || arg == "--thumbnails")
+        {
+            if (i + 1 < argc)
+            {
+                thumbnail_path = argv[i + 1];
+                interactive = false;
+                i++;
+            }
+            else
+            {
+                std::cerr << "Error: -T/--thumbnails requires a file path" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "-a" || arg == "--archive")
+        {
+            if (i + 1 < argc)
+            {
+                archive_path = argv[i + 1];
+                interactive = false;
+                i++;
+            }
+            else
+            {
+                std::cerr << "Error: -a/--archive requires a file path or -" << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "-z" || arg == "--zstd")
+        {
+            archive.compression_level = 3;
+        }
+        else if (arg == "-n" || arg == "--no-catalog")
+        {
+            use_catalog = false;
+        }
+        else if (arg == "-t" || arg == "--by-date")
+        {
+            by_date = true;
+        }
         else if (arg == "-h" || arg == "--help")
         {
             print_usage(argv[0]);
@@ -409,6 +599,12 @@ int main(int argc, char* argv[])
         }
     }
 
+    // The archive owns stdout; progress messages go to stderr instead
+    if (archive_path == "-")
+    {
+        std::cout.rdbuf(std::cerr.rdbuf());
+    }
+
     std::cout << "iOS Photo Manager" << std::endl;
     std::cout << "=================" << std::endl;
 
@@ -439,10 +635,19 @@ int main(int argc, char* argv[])
         return 1;
     }
 
+    if (use_catalog)
+    {
+        photos.open_catalog(device.get_unique_device_id());
+    }
+
     // Execute based on mode
     if (list_only)
     {
-        list_photos_interactive(photos);
+        list_photos_interactive(photos, by_date);
+    }
+    else if (first_count > 0)
+    {
+        stream_photos(photos, first_count);
     }
     else if (stats_only)
     {
@@ -461,6 +666,67 @@ int main(int argc, char* argv[])
             return 1;
         }
     }
+    else if (!backup_dir.empty())
+    {
+        std::cout << "\nBacking up DCIM to: " << backup_dir << std::endl;
+        if (!photos.backup_photos(backup_dir))
+        {
+            std::cout << "Some files could not be backed up." << std::endl;
+            return 1;
+        }
+        std::cout << "Backup complete!" << std::endl;
+    }
+    else if (!store_dir.empty())
+    {
+        media_store store(store_dir);
+        std::cout << "\nAdding DCIM to media store: " << store_dir << std::endl;
+        if (!store.open() || !photos.store_photos(store, device.get_unique_device_id()))
+        {
+            std::cout << "Some files could not be stored." << std::endl;
+            return 1;
+        }
+        std::cout << "Store updated!" << std::endl;
+    }
+    else if (!thumbnail_path.empty())
+    {
+        thumbnail_cache cache(thumbnail_path);
+        cache.load();
+        std::cout << "\nCaching photo previews in: " << thumbnail_path << std::endl;
+        if (!photos.cache_thumbnails(photos.list_all_photos(), cache))
+        {
+            std::cout << "Some previews could not be cached." << std::endl;
+            return 1;
+        }
+        std::cout << "Thumbnail cache updated!" << std::endl;
+    }
+    else if (!archive_path.empty())
+    {
+#ifdef _WIN32
+        int flags = O_WRONLY | O_CREAT | O_TRUNC | O_BINARY;
+#else
+        int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#endif
+        int fd = (archive_path == "-") ? 1 : open(archive_path.c_str(), flags, 0644);
+        if (fd < 0)
+        {
+            std::cerr << "Error: Failed to create archive: " << archive_path << std::endl;
+            return 1;
+        }
+
+        std::cout << "\nArchiving DCIM to: " << archive_path << std::endl;
+        bool archived = photos.archive_all_photos(fd, archive);
+        if (fd != 1)
+        {
+            close(fd);
+        }
+
+        if (!archived)
+        {
+            std::cout << "Archive is incomplete." << std::endl;
+            return 1;
+        }
+        std::cout << "Archive complete!" << std::endl;
+    }
     else if (interactive)
     {
         interactive_mode(photos);